@@ -42,11 +42,24 @@
 
 #define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
 #define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+#define WATERMARK_CHECK(p_buffer, old_count) {if(NULL!=(p_buffer)->p_watermark){watermark_fire((p_buffer), (old_count));}}
+
+/* first four bytes of a serialized buffer */
+#define SERIAL_MAGIC "FKCB"
 /*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
 
 
 
 /*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static void serial_put_u32(uint8_t *p_dst, uint32_t value);
+static void serial_put_u64(uint8_t *p_dst, uint64_t value);
+static uint32_t serial_get_u32(const uint8_t *p_src);
+static uint64_t serial_get_u64(const uint8_t *p_src);
+static int serial_write_chunked(circularBuffer_writer_t fp_writer, void *p_context, const uint8_t *p_data, size_t size, size_t chunk_size);
+static void watermark_fire(const circularBuffer_t *p_buffer, size_t old_count);
+static FK_CB_KW_INLINE void item_copy(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t size, memcpy_t fp_memcpy);
+static int byte_search(const circularBuffer_t *p_buffer, size_t from, size_t n, uint8_t byte, size_t *p_index);
+static bool multi_repeated(circularBuffer_t * const *pp_buffers, size_t i);
 
 
 
@@ -73,6 +86,8 @@ int circularBuffer_init(circularBuffer_t *p_buffer, void *p_data_buffer, size_t
 	p_buffer->buffer_slots = data_buffer_size / item_size;
 	p_buffer->data_size = item_size;
 	p_buffer->p_data_location = p_data_buffer;
+	p_buffer->p_watermark = NULL;
+	p_buffer->write_seq = 0;
 
     return CIRC_BUF_NO_ERROR;
 }
@@ -112,19 +127,20 @@ int circularBuffer_getCount(const circularBuffer_t *p_buffer, size_t *result)
 int circularBuffer_push(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
 {
 	VERIFY_ADDR(p_buffer);
-	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
 
 	if(p_buffer->count > p_buffer->buffer_slots - 1) {
 		return CIRC_BUF_BUFFER_FULL;
 	}
 
-	fp_memcpy((uint8_t *)(p_buffer->p_data_location) + (p_buffer->end)*p_buffer->data_size, p_data, p_buffer->data_size);
+	item_copy((uint8_t *)(p_buffer->p_data_location) + (p_buffer->end)*p_buffer->data_size, p_data, p_buffer->data_size, fp_memcpy);
 
 	p_buffer->count++;
+	p_buffer->write_seq++;
 	p_buffer->end++;
 	if(p_buffer->end >= p_buffer->buffer_slots) {
 		p_buffer->end = 0;
 	}
+	WATERMARK_CHECK(p_buffer, p_buffer->count - 1);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -171,12 +187,140 @@ int circularBuffer_push_n(circularBuffer_t *p_buffer, const void * FK_CB_KW_REST
 	}
 
 	p_buffer->count += n;
+	p_buffer->write_seq += n;
+	p_buffer->end = (p_buffer->end + n) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count - n);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_push_iov(circularBuffer_t *p_buffer, const circularBufferIovec_t *p_iov, int iovcnt, memcpy_t fp_memcpy)
+{
+	size_t capacity;
+	size_t total = 0;
+	size_t offset;
+	size_t remaining;
+	size_t chunk;
+	size_t n;
+	int i;
+
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_iov);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	if (iovcnt <= 0) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	capacity = p_buffer->buffer_slots * p_buffer->data_size;
+	for (i = 0; i < iovcnt; i++) {
+		if (p_iov[i].iov_len > capacity - total) {
+			return CIRC_BUF_SIZE_ERROR;
+		}
+		total += p_iov[i].iov_len;
+	}
+	if (0 == total || total % p_buffer->data_size != 0) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	n = total / p_buffer->data_size;
+	if(p_buffer->count > p_buffer->buffer_slots - n) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+
+	offset = p_buffer->end * p_buffer->data_size;
+	for (i = 0; i < iovcnt; i++) {
+		remaining = p_iov[i].iov_len;
+		while (remaining > 0) {
+			/* split a region that runs past the end of storage */
+			chunk = capacity - offset < remaining ? capacity - offset : remaining;
+			fp_memcpy(
+				p_buffer->p_data_location + offset,
+				(const uint8_t *)p_iov[i].iov_base + (p_iov[i].iov_len - remaining),
+				chunk
+			);
+			remaining -= chunk;
+			offset += chunk;
+			if (offset == capacity) {
+				offset = 0;
+			}
+		}
+	}
+
+	p_buffer->count += n;
+	p_buffer->write_seq += n;
 	p_buffer->end = (p_buffer->end + n) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count - n);
 
 	return CIRC_BUF_NO_ERROR;
 }
 
 
+int circularBuffer_push_multi(circularBuffer_t * const *pp_buffers, size_t k, const void * FK_CB_KW_RESTRICT p_data, int policy, int *p_status, memcpy_t fp_memcpy)
+{
+	circularBuffer_t *p_buffer;
+	size_t data_size = 0;
+	size_t i;
+	int status;
+	int ret = CIRC_BUF_NO_ERROR;
+	VERIFY_ADDR(pp_buffers);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(k);
+
+	/* check every buffer before writing any */
+	for (i = 0; i < k; i++) {
+		p_buffer = pp_buffers[i];
+		if (NULL == p_buffer || multi_repeated(pp_buffers, i)) {
+			status = CIRC_BUF_ADDR_ERROR;
+		} else if (data_size != 0 && p_buffer->data_size != data_size) {
+			status = CIRC_BUF_SIZE_ERROR;
+		} else if (p_buffer->count > p_buffer->buffer_slots - 1) {
+			status = CIRC_BUF_BUFFER_FULL;
+		} else {
+			status = CIRC_BUF_NO_ERROR;
+		}
+		if (p_buffer != NULL && 0 == data_size) {
+			data_size = p_buffer->data_size;
+		}
+		if (status != CIRC_BUF_NO_ERROR && CIRC_BUF_NO_ERROR == ret) {
+			ret = status;
+		}
+		if (p_status != NULL) {
+			p_status[i] = status;
+		}
+	}
+
+	if (ret != CIRC_BUF_NO_ERROR && CIRC_BUF_MULTI_ALL == policy) {
+		if (p_status != NULL) {
+			for (i = 0; i < k; i++) {
+				if (CIRC_BUF_NO_ERROR == p_status[i]) {
+					p_status[i] = CIRC_BUF_SKIPPED;
+				}
+			}
+		}
+		return ret;
+	}
+
+	for (i = 0; i < k; i++) {
+		p_buffer = pp_buffers[i];
+		if (NULL == p_buffer || p_buffer->data_size != data_size || p_buffer->count > p_buffer->buffer_slots - 1
+			|| multi_repeated(pp_buffers, i)) {
+			continue;
+		}
+
+		item_copy(p_buffer->p_data_location + p_buffer->end * data_size, p_data, data_size, fp_memcpy);
+		p_buffer->count++;
+		p_buffer->write_seq++;
+		p_buffer->end++;
+		if (p_buffer->end >= p_buffer->buffer_slots) {
+			p_buffer->end = 0;
+		}
+		WATERMARK_CHECK(p_buffer, p_buffer->count - 1);
+	}
+
+	return ret;
+}
+
 int circularBuffer_peek(const circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
 {
 	size_t bytes_copied = 0;
@@ -217,22 +361,153 @@ int circularBuffer_peek(const circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRI
 	return CIRC_BUF_NO_ERROR;
 }
 
+int circularBuffer_peek_spans(const circularBuffer_t *p_buffer, size_t offset, size_t n, circularBufferSpan_t spans[2], size_t *span_count)
+{
+	size_t first;
+	size_t first_items;
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(spans);
+	VERIFY_SIZE(n);
+
+	if (offset >= p_buffer->count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > p_buffer->count - offset) {
+		n = p_buffer->count - offset;
+	}
+
+	first = (p_buffer->start + offset) % p_buffer->buffer_slots;
+	first_items = p_buffer->buffer_slots - first;
+	if (first_items > n) {
+		first_items = n;
+	}
+
+	spans[0].p_data = p_buffer->p_data_location + first * p_buffer->data_size;
+	spans[0].size = first_items * p_buffer->data_size;
+	spans[1].p_data = p_buffer->p_data_location;
+	spans[1].size = (n - first_items) * p_buffer->data_size;
+
+	if (span_count != NULL) {
+		*span_count = spans[1].size ? 2 : 1;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_find_byte(const circularBuffer_t *p_buffer, size_t from, uint8_t byte, size_t *p_index)
+{
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_index);
+
+	if (p_buffer->data_size != 1) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (from >= p_buffer->count) {
+		return CIRC_BUF_NOT_FOUND;
+	}
+
+	return byte_search(p_buffer, from, p_buffer->count - from, byte, p_index);
+}
+
+int circularBuffer_pop_until(circularBuffer_t *p_buffer, uint8_t byte, void * FK_CB_KW_RESTRICT p_data, size_t max, size_t *p_popped, memcpy_t fp_memcpy)
+{
+	size_t index;
+	size_t n;
+	int ret;
+
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(max);
+
+	if (p_popped != NULL) {
+		*p_popped = 0;
+	}
+	if (p_buffer->data_size != 1) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (0 == p_buffer->count) {
+		return CIRC_BUF_NOT_FOUND;
+	}
+
+	n = p_buffer->count < max ? p_buffer->count : max;
+	ret = byte_search(p_buffer, 0, n, byte, &index);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return n == max ? CIRC_BUF_SIZE_ERROR : ret;
+	}
+
+	circularBuffer_popFIFO_n(p_buffer, p_data, index + 1, fp_memcpy);
+	if (p_popped != NULL) {
+		*p_popped = index + 1;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_read_next(const circularBuffer_t *p_buffer, circularBufferReadTxn_t *p_txn, size_t n, circularBufferSpan_t spans[2], size_t *span_count)
+{
+	int ret;
+	VERIFY_ADDR(p_txn);
+
+	ret = circularBuffer_peek_spans(p_buffer, p_txn->cursor, n, spans, span_count);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		p_txn->cursor += (spans[0].size + spans[1].size) / p_buffer->data_size;
+	}
+
+	return ret;
+}
+
+int circularBuffer_read_mark(circularBufferReadTxn_t *p_txn)
+{
+	VERIFY_ADDR(p_txn);
+
+	p_txn->mark = p_txn->cursor;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_read_rollback(circularBufferReadTxn_t *p_txn)
+{
+	VERIFY_ADDR(p_txn);
+
+	p_txn->cursor = p_txn->mark;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_read_commit(circularBuffer_t *p_buffer, circularBufferReadTxn_t *p_txn)
+{
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_txn);
+
+	if (p_txn->cursor > p_buffer->count) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	if (p_txn->mark != 0) {
+		circularBuffer_remove_records(p_buffer, p_txn->mark);
+	}
+	p_txn->cursor -= p_txn->mark;
+	p_txn->mark = 0;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
 int circularBuffer_popFIFO(circularBuffer_t * p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
 {
 	VERIFY_ADDR(p_buffer);
-	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
 
 	if(0 == p_buffer->count) {
 		return CIRC_BUF_BUFFER_EMPTY;
 	}
 
-	circularBuffer_peek(p_buffer, p_data, 1, fp_memcpy);
+	item_copy(p_data, (uint8_t *)p_buffer->p_data_location + (p_buffer->start)*p_buffer->data_size, p_buffer->data_size, fp_memcpy);
 
 	p_buffer->count--;
 	p_buffer->start++;
 	if(p_buffer->start >= p_buffer->buffer_slots) {
 		p_buffer->start = 0;
 	}
+	WATERMARK_CHECK(p_buffer, p_buffer->count + 1);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -253,6 +528,7 @@ int circularBuffer_popFIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRIC
 
 	p_buffer->count -= n;
 	p_buffer->start = (p_buffer->start + n) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count + n);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -271,6 +547,77 @@ int circularBuffer_remove_records(circularBuffer_t *p_buffer, size_t n)
 
 	p_buffer->count -= n;
 	p_buffer->start = (p_buffer->start + n) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count + n);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_add_records(circularBuffer_t *p_buffer, size_t n)
+{
+	VERIFY_ADDR(p_buffer);
+	VERIFY_SIZE(n);
+
+	if (n > p_buffer->buffer_slots - p_buffer->count) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+
+	p_buffer->count += n;
+	p_buffer->write_seq += n;
+	p_buffer->end = (p_buffer->end + n) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count - n);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_filter(circularBuffer_t *p_buffer, circularBuffer_predicate_t fp_keep, void *p_context, size_t *p_removed, memcpy_t fp_memcpy)
+{
+	size_t read_slot;
+	size_t write_slot;
+	size_t kept = 0;
+	size_t i;
+	size_t old_count;
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(fp_keep);
+
+	if (p_removed != NULL) {
+		*p_removed = 0;
+	}
+	if (0 == p_buffer->count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	read_slot = p_buffer->start;
+	write_slot = p_buffer->start;
+	for (i = 0; i < p_buffer->count; i++) {
+		if (fp_keep(p_context, p_buffer->p_data_location + read_slot * p_buffer->data_size)) {
+			if (write_slot != read_slot) {
+				item_copy(
+					p_buffer->p_data_location + write_slot * p_buffer->data_size,
+					p_buffer->p_data_location + read_slot * p_buffer->data_size,
+					p_buffer->data_size,
+					fp_memcpy
+				);
+				p_buffer->write_seq++;
+			}
+			kept++;
+			write_slot++;
+			if (write_slot >= p_buffer->buffer_slots) {
+				write_slot = 0;
+			}
+		}
+		read_slot++;
+		if (read_slot >= p_buffer->buffer_slots) {
+			read_slot = 0;
+		}
+	}
+
+	old_count = p_buffer->count;
+	p_buffer->count = kept;
+	p_buffer->end = write_slot;
+	if (p_removed != NULL) {
+		*p_removed = old_count - kept;
+	}
+	WATERMARK_CHECK(p_buffer, old_count);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -278,7 +625,6 @@ int circularBuffer_remove_records(circularBuffer_t *p_buffer, size_t n)
 int circularBuffer_popLIFO(circularBuffer_t * p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
 {
 	VERIFY_ADDR(p_buffer);
-	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
 
 	if (0 == p_buffer->count) {
 		return CIRC_BUF_BUFFER_EMPTY;
@@ -289,12 +635,14 @@ int circularBuffer_popLIFO(circularBuffer_t * p_buffer, void * FK_CB_KW_RESTRICT
 	} else{
 		p_buffer->end--;
 	}
-	fp_memcpy(
+	item_copy(
 		p_data,
 		(uint8_t *)p_buffer->p_data_location + (p_buffer->end)*p_buffer->data_size,
-		p_buffer->data_size
+		p_buffer->data_size,
+		fp_memcpy
 	);
 	p_buffer->count--;
+	WATERMARK_CHECK(p_buffer, p_buffer->count + 1);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -343,6 +691,7 @@ int circularBuffer_popLIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRIC
 
 	p_buffer->count -= n;
 	p_buffer->end = (p_buffer->start + p_buffer->count) % p_buffer->buffer_slots;
+	WATERMARK_CHECK(p_buffer, p_buffer->count + n);
 
 	return CIRC_BUF_NO_ERROR;
 }
@@ -375,12 +724,286 @@ int circularBuffer_copy(circularBuffer_t *dst, const circularBuffer_t *src, memc
 	dst->start = src->start;
 	dst->end = src->end;
 	dst->count = src->count;
+	/* every slot of dst changes: put it past any replica of dst, as deserialize does */
+	dst->write_seq = (dst->write_seq > src->write_seq ? dst->write_seq : src->write_seq) + src->buffer_slots;
 	fp_memcpy(dst->p_data_location, src->p_data_location, src_buffer_size);
 
 	return CIRC_BUF_NO_ERROR;
 }
+
+int circularBuffer_sync(circularBuffer_t *dst, const circularBuffer_t *src, memcpy_t fp_memcpy)
+{
+	int ret;
+	size_t n;
+	size_t first;
+	size_t first_items;
+	VERIFY_ADDR(dst);
+	VERIFY_ADDR(src);
+
+	if (dst->data_size != src->data_size || dst->buffer_slots != src->buffer_slots
+		|| dst->write_seq > src->write_seq || src->write_seq - dst->write_seq >= src->buffer_slots) {
+		ret = circularBuffer_copy(dst, src, fp_memcpy);
+		if (CIRC_BUF_NO_ERROR == ret) {
+			dst->write_seq = src->write_seq;
+		}
+		return ret;
+	}
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	/*
+	 * Every slot written since the last sync that still holds an item lies
+	 * within the last n slots before end: end only moves forward by writing.
+	 */
+	n = (size_t)(src->write_seq - dst->write_seq);
+	if (n != 0) {
+		first = (src->end + src->buffer_slots - n) % src->buffer_slots;
+		first_items = src->buffer_slots - first;
+		if (first_items > n) {
+			first_items = n;
+		}
+		fp_memcpy(
+			dst->p_data_location + first * src->data_size,
+			src->p_data_location + first * src->data_size,
+			first_items * src->data_size
+		);
+		if (n > first_items) {
+			fp_memcpy(dst->p_data_location, src->p_data_location, (n - first_items) * src->data_size);
+		}
+	}
+
+	dst->start = src->start;
+	dst->end = src->end;
+	dst->count = src->count;
+	dst->write_seq = src->write_seq;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_serialize(const circularBuffer_t *p_buffer, circularBuffer_writer_t fp_writer, void *p_context, size_t chunk_size)
+{
+	uint8_t header[CIRC_BUF_SERIAL_HEADER_SIZE];
+	circularBufferSpan_t spans[2];
+	size_t i;
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(fp_writer);
+
+	memcpy(header, SERIAL_MAGIC, 4);
+	serial_put_u32(header + 4, CIRC_BUF_SERIAL_VERSION);
+	serial_put_u64(header + 8, p_buffer->data_size);
+	serial_put_u64(header + 16, p_buffer->buffer_slots);
+	serial_put_u64(header + 24, p_buffer->count);
+	if (fp_writer(p_context, header, sizeof(header)) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	if (0 == p_buffer->count) {
+		return CIRC_BUF_NO_ERROR;
+	}
+
+	circularBuffer_peek_spans(p_buffer, 0, p_buffer->count, spans, NULL);
+	for (i = 0; i < 2; i++) {
+		if (serial_write_chunked(fp_writer, p_context, spans[i].p_data, spans[i].size, chunk_size) != 0) {
+			return CIRC_BUF_IO_ERROR;
+		}
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_deserialize(circularBuffer_t *p_buffer, circularBuffer_reader_t fp_reader, void *p_context, size_t chunk_size)
+{
+	uint8_t header[CIRC_BUF_SERIAL_HEADER_SIZE];
+	uint64_t count;
+	size_t bytes_to_read;
+	size_t bytes_read = 0;
+	size_t chunk;
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(fp_reader);
+
+	circularBuffer_flush(p_buffer);
+
+	if (fp_reader(p_context, header, sizeof(header)) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (memcmp(header, SERIAL_MAGIC, 4) != 0 || serial_get_u32(header + 4) != CIRC_BUF_SERIAL_VERSION) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	count = serial_get_u64(header + 24);
+	if (count > serial_get_u64(header + 16)) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	if (serial_get_u64(header + 8) != p_buffer->data_size || count > p_buffer->buffer_slots) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	/* every slot may change; make the next circularBuffer_sync copy them all */
+	p_buffer->write_seq += p_buffer->buffer_slots;
+	bytes_to_read = (size_t)count * p_buffer->data_size;
+	while (bytes_read < bytes_to_read) {
+		chunk = bytes_to_read - bytes_read;
+		if (chunk_size != 0 && chunk > chunk_size) {
+			chunk = chunk_size;
+		}
+		if (fp_reader(p_context, p_buffer->p_data_location + bytes_read, chunk) != 0) {
+			return CIRC_BUF_IO_ERROR;
+		}
+		bytes_read += chunk;
+	}
+
+	p_buffer->count = (size_t)count;
+	p_buffer->end = p_buffer->count % p_buffer->buffer_slots;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBuffer_set_watermark(circularBuffer_t *p_buffer, circularBufferWatermark_t *p_watermark)
+{
+	VERIFY_ADDR(p_buffer);
+
+	if (p_watermark != NULL) {
+		if (p_watermark->low >= p_watermark->high || p_watermark->high > p_buffer->buffer_slots) {
+			return CIRC_BUF_SIZE_ERROR;
+		}
+		p_watermark->events = 0;
+	}
+	p_buffer->p_watermark = p_watermark;
+
+	return CIRC_BUF_NO_ERROR;
+}
 /*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static void serial_put_u32(uint8_t *p_dst, uint32_t value)
+{
+	size_t i;
+	for (i = 0; i < 4; i++) {
+		p_dst[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static void serial_put_u64(uint8_t *p_dst, uint64_t value)
+{
+	size_t i;
+	for (i = 0; i < 8; i++) {
+		p_dst[i] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+static uint32_t serial_get_u32(const uint8_t *p_src)
+{
+	uint32_t value = 0;
+	size_t i;
+	for (i = 0; i < 4; i++) {
+		value |= (uint32_t)p_src[i] << (8 * i);
+	}
+	return value;
+}
+
+static uint64_t serial_get_u64(const uint8_t *p_src)
+{
+	uint64_t value = 0;
+	size_t i;
+	for (i = 0; i < 8; i++) {
+		value |= (uint64_t)p_src[i] << (8 * i);
+	}
+	return value;
+}
+
+static int serial_write_chunked(circularBuffer_writer_t fp_writer, void *p_context, const uint8_t *p_data, size_t size, size_t chunk_size)
+{
+	size_t chunk;
+
+	while (size > 0) {
+		chunk = size;
+		if (chunk_size != 0 && chunk > chunk_size) {
+			chunk = chunk_size;
+		}
+		if (fp_writer(p_context, p_data, chunk) != 0) {
+			return -1;
+		}
+		p_data += chunk;
+		size -= chunk;
+	}
+	return 0;
+}
 
+static void watermark_fire(const circularBuffer_t *p_buffer, size_t old_count)
+{
+	circularBufferWatermark_t *p_watermark = p_buffer->p_watermark;
+	unsigned int event;
 
+	if (old_count < p_watermark->high && p_buffer->count >= p_watermark->high) {
+		event = CIRC_BUF_WATERMARK_HIGH;
+	} else if (old_count > p_watermark->low && p_buffer->count <= p_watermark->low) {
+		event = CIRC_BUF_WATERMARK_LOW;
+	} else {
+		return;
+	}
+
+	p_watermark->events |= event;
+	if (p_watermark->fp_callback != NULL) {
+		p_watermark->fp_callback(p_watermark->p_context, p_buffer, event);
+	}
+}
+
+/*
+ * Copy one item. With FK_CB_FAST_PATH defined and no caller-supplied copy
+ * routine, the common item sizes are copied with a constant-size memcpy that
+ * the compiler expands to a few moves instead of a library call.
+ */
+static FK_CB_KW_INLINE void item_copy(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t size, memcpy_t fp_memcpy)
+{
+	if (NULL == fp_memcpy) {
+#ifdef FK_CB_FAST_PATH
+		switch (size) {
+		case 1: memcpy(dst, src, 1); return;
+		case 2: memcpy(dst, src, 2); return;
+		case 4: memcpy(dst, src, 4); return;
+		case 8: memcpy(dst, src, 8); return;
+		case 16: memcpy(dst, src, 16); return;
+		case 64: memcpy(dst, src, 64); return;
+		default: break;
+		}
+#endif
+		fp_memcpy = memcpy;
+	}
+	fp_memcpy(dst, src, size);
+}
+
+/* search \p n 1-byte items starting \p from items after the beginning */
+static int byte_search(const circularBuffer_t *p_buffer, size_t from, size_t n, uint8_t byte, size_t *p_index)
+{
+	circularBufferSpan_t spans[2];
+	const uint8_t *p_match;
+
+	circularBuffer_peek_spans(p_buffer, from, n, spans, NULL);
+
+	p_match = memchr(spans[0].p_data, byte, spans[0].size);
+	if (p_match != NULL) {
+		*p_index = from + (size_t)(p_match - spans[0].p_data);
+		return CIRC_BUF_NO_ERROR;
+	}
+	if (spans[1].size != 0) {
+		p_match = memchr(spans[1].p_data, byte, spans[1].size);
+		if (p_match != NULL) {
+			*p_index = from + spans[0].size + (size_t)(p_match - spans[1].p_data);
+			return CIRC_BUF_NO_ERROR;
+		}
+	}
+
+	return CIRC_BUF_NOT_FOUND;
+}
+
+/* whether entry \p i of \p pp_buffers repeats an earlier entry */
+static bool multi_repeated(circularBuffer_t * const *pp_buffers, size_t i)
+{
+	size_t j;
+
+	for (j = 0; j < i; j++) {
+		if (pp_buffers[j] == pp_buffers[i]) {
+			return true;
+		}
+	}
+
+	return false;
+}
 
 /*-------------------------EOF----------------------------------------------*/
@@ -68,9 +68,50 @@
 #define CIRC_BUF_ADDR_ERROR -3
 /** Invalid size used (too large or too small)  */
 #define CIRC_BUF_SIZE_ERROR -4
+/** Writer or reader callback reported a failure */
+#define CIRC_BUF_IO_ERROR -5
+/** Serialized data is malformed or from an unsupported version */
+#define CIRC_BUF_FORMAT_ERROR -6
+/** Operation gave up after the configured number of attempts */
+#define CIRC_BUF_RETRY_ERROR -7
+/** Searched-for item is not in the buffer */
+#define CIRC_BUF_NOT_FOUND -8
+/** Not attempted because another part of the same call failed */
+#define CIRC_BUF_SKIPPED -9
+
+/** Version written by circularBuffer_serialize */
+#define CIRC_BUF_SERIAL_VERSION 1
+/** Size in bytes of the header written by circularBuffer_serialize */
+#define CIRC_BUF_SERIAL_HEADER_SIZE 32
+/** Watermark event: the item count rose to the high watermark */
+#define CIRC_BUF_WATERMARK_HIGH 0x1u
+/** Watermark event: the item count fell to the low watermark */
+#define CIRC_BUF_WATERMARK_LOW 0x2u
+/** circularBuffer_push_multi policy: push to every buffer or to none */
+#define CIRC_BUF_MULTI_ALL 0
+/** circularBuffer_push_multi policy: push to every buffer with room */
+#define CIRC_BUF_MULTI_ANY 1
 
 /*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
 
+struct circularBuffer;
+
+/**
+ * Called when the item count of \p p_buffer crosses a watermark. \p event is
+ * `CIRC_BUF_WATERMARK_HIGH` or `CIRC_BUF_WATERMARK_LOW`. The buffer has already
+ * been updated when this is called.
+ */
+typedef void (* circularBuffer_watermark_cb_t)(void *p_context, const struct circularBuffer *p_buffer, unsigned int event);
+
+/** Watermarks registered with circularBuffer_set_watermark */
+typedef struct circularBufferWatermark{
+	size_t high; /**< Fire when the count rises from below \p high to \p high or more */
+	size_t low; /**< Fire when the count falls from above \p low to \p low or less */
+	circularBuffer_watermark_cb_t fp_callback; /**< Called on each crossing. May be `NULL`. */
+	void *p_context; /**< Passed to \p fp_callback */
+	unsigned int events; /**< Events fired since the caller last cleared this field */
+} circularBufferWatermark_t;
+
 /** Circular buffer */
 typedef struct circularBuffer{
 	size_t data_size;  /**< Size of an individual element */
@@ -79,12 +120,15 @@ typedef struct circularBuffer{
 	size_t end; /**< End index */
 	size_t count; /**< Elements in use */
 	uint8_t *p_data_location;  /**< data pointer */
+	circularBufferWatermark_t *p_watermark; /**< Registered watermarks, or `NULL` */
+	uint64_t write_seq; /**< Items written since init; see circularBuffer_sync */
 } circularBuffer_t;
 
 #ifdef __STDC_VERSION__
 #if __STDC_VERSION__ >= 199901L
    /*C99*/
 	#define FK_CB_KW_RESTRICT restrict
+	#define FK_CB_KW_INLINE inline
 #endif
 #endif
 
@@ -92,6 +136,77 @@ typedef struct circularBuffer{
 #define FK_CB_KW_RESTRICT
 #endif
 
+#ifndef FK_CB_KW_INLINE
+#if defined(__GNUC__)
+	#define FK_CB_KW_INLINE __inline__
+#else
+	#define FK_CB_KW_INLINE
+#endif
+#endif
+
+/*
+ * Define FK_CB_HEADER_ONLY before including this file to compile the core
+ * into the including translation unit as static inline functions, so that
+ * push and pop can be inlined into the caller. fk_circular_buffer.c must then
+ * be on the include path. The optional modules are compiled without it and
+ * call the core's external functions, so a build that uses any module must
+ * still compile fk_circular_buffer.c on its own as well; give that object the
+ * same FK_CB_FAST_PATH setting. Only a build without modules can leave it out.
+ */
+#ifdef FK_CB_HEADER_ONLY
+#define FK_CB_API static FK_CB_KW_INLINE
+#else
+#define FK_CB_API
+#endif
+
+/** Contiguous region of buffer storage */
+typedef struct circularBufferSpan{
+	uint8_t *p_data; /**< Start of the region inside `p_data_location` */
+	size_t size; /**< Size of the region in bytes */
+} circularBufferSpan_t;
+
+/**
+ * Sink for circularBuffer_serialize. Must consume all \p size bytes of
+ * \p p_data and return 0, or return nonzero on failure.
+ */
+typedef int (* circularBuffer_writer_t)(void *p_context, const void *p_data, size_t size);
+
+/**
+ * Source for circularBuffer_deserialize. Must fill all \p size bytes of
+ * \p p_data and return 0, or return nonzero on failure or short input.
+ */
+typedef int (* circularBuffer_reader_t)(void *p_context, void *p_data, size_t size);
+
+/**
+ * Test for circularBuffer_filter. Returns true to keep \p p_item, which points
+ * into the buffer's storage.
+ */
+typedef bool (* circularBuffer_predicate_t)(void *p_context, const void *p_item);
+
+/**
+ * One source region for circularBuffer_push_iov. Has the same members as POSIX
+ * `struct iovec` but is a distinct type: accessing a `struct iovec` array
+ * through a pointer to this type violates strict aliasing, so copy the
+ * members into a circularBufferIovec_t array instead of casting the pointer.
+ */
+typedef struct circularBufferIovec{
+	const void *iov_base; /**< Start of the region */
+	size_t iov_len; /**< Size of the region in bytes */
+} circularBufferIovec_t;
+
+/**
+ * Read transaction for circularBuffer_read_next. Only offsets from the start
+ * of the buffer are held, so items may be pushed during a transaction; nothing
+ * else may remove items until it is committed or abandoned.
+ */
+typedef struct circularBufferReadTxn{
+	size_t cursor; /**< Items read so far */
+	size_t mark; /**< Items to consume on commit */
+} circularBufferReadTxn_t;
+
+/** Initializer for an empty circularBufferReadTxn_t */
+#define CIRC_BUF_READ_TXN_INIT {0, 0}
+
 /** pointer to a function with the same signature as memcpy */
 typedef void *(* memcpy_t)(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num);
 /*-------------------------EXPORTED VARIABLES ------------------------------*/
@@ -116,7 +231,7 @@ typedef void *(* memcpy_t)(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_R
  * @retval CIRC_BUF_NO_ERROR on success
  *
  ******************************************************************************/
-int circularBuffer_init(circularBuffer_t *p_buffer, void * p_data_buffer, size_t data_buffer_size, size_t item_size);
+FK_CB_API int circularBuffer_init(circularBuffer_t *p_buffer, void * p_data_buffer, size_t data_buffer_size, size_t item_size);
 
 /**
  * Flush (empty) a circular buffer
@@ -126,7 +241,7 @@ int circularBuffer_init(circularBuffer_t *p_buffer, void * p_data_buffer, size_t
  * @retval CIRC_BUF_NO_ERROR on success
  *
  ******************************************************************************/
-int circularBuffer_flush(circularBuffer_t *p_buffer);
+FK_CB_API int circularBuffer_flush(circularBuffer_t *p_buffer);
 
 /**
  * Determine if a circular buffer is full
@@ -135,7 +250,7 @@ int circularBuffer_flush(circularBuffer_t *p_buffer);
  * @return Whether the buffer is full
  *
  ******************************************************************************/
-bool circularBuffer_is_full(const circularBuffer_t * p_buffer);
+FK_CB_API bool circularBuffer_is_full(const circularBuffer_t * p_buffer);
 
 /**
  * Determine if a circular buffer is empty
@@ -144,7 +259,7 @@ bool circularBuffer_is_full(const circularBuffer_t * p_buffer);
  * @return Whether the buffer is empty
  *
  ******************************************************************************/
-bool circularBuffer_is_empty(const circularBuffer_t *p_buffer);
+FK_CB_API bool circularBuffer_is_empty(const circularBuffer_t *p_buffer);
 
 /**
  * Get number of items in a buffer
@@ -154,7 +269,7 @@ bool circularBuffer_is_empty(const circularBuffer_t *p_buffer);
  * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p result is `NULL`
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_getCount(const circularBuffer_t *p_buffer, size_t *result);
+FK_CB_API int circularBuffer_getCount(const circularBuffer_t *p_buffer, size_t *result);
 
 /**
  * Push 1 item from \p p_data onto the end of \p p_buffer.
@@ -169,7 +284,7 @@ int circularBuffer_getCount(const circularBuffer_t *p_buffer, size_t *result);
  * @retval CIRC_BUF_BUFFER_FULL if \p p_buffer is full
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_push(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_push(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
 
 /**
  * Push \p n items from \p p_data onto the end of \p p_buffer
@@ -186,7 +301,55 @@ int circularBuffer_push(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRI
  * @retval CIRC_BUF_BUFFER_FULL if \p p_buffer cannot accept \p n more items
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_push_n(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_push_n(circularBuffer_t *p_buffer, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Push the concatenation of \p iovcnt regions onto the end of \p p_buffer,
+ * as one call to circularBuffer_push_n would. Regions need not hold whole
+ * items; only their total size must be a multiple of the item size. Either
+ * every byte is pushed or nothing is.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] p_iov array of \p iovcnt regions. None may overlap with
+ 	\p p_buffer->p_data_location.
+ * @param[in] iovcnt number of regions
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p p_iov is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p iovcnt is not positive, or the total size
+ 	is zero, not a multiple of \p p_buffer->data_size, or more than the
+ 	buffer holds
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_buffer cannot accept that many more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_push_iov(circularBuffer_t *p_buffer, const circularBufferIovec_t *p_iov, int iovcnt, memcpy_t fp_memcpy);
+
+/**
+ * Push 1 item to each of \p k buffers, e.g. to fan a record out to
+ * subscribers. Every buffer is checked before any is written, then the item
+ * is copied into each buffer with room while it is still in cache.
+ *
+ * @param[in] pp_buffers the buffers. All must have the same item size, and
+ 	each may appear only once.
+ * @param[in] k number of buffers
+ * @param[in] p_data pointer to one item
+ * @param[in] policy `CIRC_BUF_MULTI_ALL` to push to no buffer unless every one
+ 	has room, or `CIRC_BUF_MULTI_ANY` to push to each buffer that has room
+ * @param[out] p_status \p k results, one per buffer: `CIRC_BUF_NO_ERROR` if
+ 	the item was pushed, `CIRC_BUF_BUFFER_FULL` if the buffer is full,
+ 	`CIRC_BUF_ADDR_ERROR` if the entry is `NULL` or repeats an earlier entry,
+ 	`CIRC_BUF_SIZE_ERROR` if its item size differs, or `CIRC_BUF_SKIPPED` if
+ 	the buffer had room but another buffer stopped an all-or-nothing push.
+ 	May be `NULL`.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p pp_buffers or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p k is zero
+ * @retval others the first failing buffer's result, if any buffer did not
+ 	take the item
+ * @retval CIRC_BUF_NO_ERROR if every buffer took the item
+ ******************************************************************************/
+FK_CB_API int circularBuffer_push_multi(circularBuffer_t * const *pp_buffers, size_t k, const void * FK_CB_KW_RESTRICT p_data, int policy, int *p_status, memcpy_t fp_memcpy);
 
 /**
  * Copy the first \p n items from \p p_buffer into \p p_data
@@ -203,7 +366,116 @@ int circularBuffer_push_n(circularBuffer_t *p_buffer, const void * FK_CB_KW_REST
  * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or \p n exceeds buffer item count
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_peek(const circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_peek(const circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Locate \p n items starting \p offset items after the beginning of \p p_buffer
+ * without copying them. The items occupy one region, or two if they wrap
+ * around the end of the storage. The regions stay valid until the items are
+ * removed from \p p_buffer. If fewer than \p n items follow \p offset, all of
+ * them are returned.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] offset number of items to skip from the beginning of \p p_buffer
+ * @param[in] n maximum number of items to locate
+ * @param[out] spans array of two regions; unused entries have a `size` of 0
+ * @param[out] span_count number of regions used (1 or 2). May be `NULL`.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p spans is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if no items follow \p offset
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_peek_spans(const circularBuffer_t *p_buffer, size_t offset, size_t n, circularBufferSpan_t spans[2], size_t *span_count);
+
+/**
+ * Find the first occurrence of \p byte in a buffer of 1-byte items, searching
+ * in place from \p from items after the beginning. The search uses `memchr`
+ * on each contiguous region, so it runs at the speed of the C library's
+ * vectorized search.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] from number of items to skip from the beginning of \p p_buffer
+ * @param[in] byte value to find
+ * @param[out] p_index offset of the match from the beginning of \p p_buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p p_index is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if the item size is not 1
+ * @retval CIRC_BUF_NOT_FOUND if \p byte does not follow \p from
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_find_byte(const circularBuffer_t *p_buffer, size_t from, uint8_t byte, size_t *p_index);
+
+/**
+ * Pop items from a buffer of 1-byte items up to and including the first
+ * \p byte, e.g. one line. Nothing is removed unless the delimiter is found
+ * within \p max items.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] byte delimiter
+ * @param[out] p_data destination, at least \p max bytes long
+ * @param[in] max most items to pop, including the delimiter
+ * @param[out] p_popped number of items popped. May be `NULL`.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if the item size is not 1, \p max is zero, or
+ 	the first \p max items hold no delimiter
+ * @retval CIRC_BUF_NOT_FOUND if fewer than \p max items are buffered and none
+ 	is the delimiter
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_pop_until(circularBuffer_t *p_buffer, uint8_t byte, void * FK_CB_KW_RESTRICT p_data, size_t max, size_t *p_popped, memcpy_t fp_memcpy);
+
+/**
+ * Locate the next \p n items of a read transaction in place, as for
+ * circularBuffer_peek_spans, and move the transaction's cursor past them.
+ * A parser that runs out of input can return later, after more items are
+ * pushed, and carry on from the cursor, so each item is read only once.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in,out] p_txn read transaction
+ * @param[in] n maximum number of items to locate
+ * @param[out] spans array of two regions; unused entries have a `size` of 0
+ * @param[out] span_count number of regions used (1 or 2). May be `NULL`.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer, \p p_txn or \p spans is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if no items follow the cursor
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_read_next(const circularBuffer_t *p_buffer, circularBufferReadTxn_t *p_txn, size_t n, circularBufferSpan_t spans[2], size_t *span_count);
+
+/**
+ * Mark everything read so far in a transaction as consumed by the next
+ * circularBuffer_read_commit, e.g. once a complete frame has been parsed.
+ *
+ * @param[in,out] p_txn read transaction
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_txn is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_read_mark(circularBufferReadTxn_t *p_txn);
+
+/**
+ * Move the cursor of a transaction back to its mark, so the items read since
+ * are read again by circularBuffer_read_next. Nothing is copied.
+ *
+ * @param[in,out] p_txn read transaction
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_txn is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_read_rollback(circularBufferReadTxn_t *p_txn);
+
+/**
+ * Remove the items up to the mark of a transaction from \p p_buffer. Items
+ * read after the mark stay in the buffer, and the cursor keeps its place
+ * among them.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in,out] p_txn read transaction
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p p_txn is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if the buffer holds fewer items than the cursor;
+ 	the transaction has been invalidated by another removal
+ * @retval CIRC_BUF_NO_ERROR on success, including when nothing was marked
+ ******************************************************************************/
+FK_CB_API int circularBuffer_read_commit(circularBuffer_t *p_buffer, circularBufferReadTxn_t *p_txn);
 
 /**
  * Copy one item from the beginning of \p p_buffer into \p p_data and remove it from \p p_buffer
@@ -218,7 +490,7 @@ int circularBuffer_peek(const circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRI
  * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_popFIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_popFIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
 
 /**
  * Copy \p n items from the beginning of \p p_buffer into \p p_data and remove them
@@ -237,7 +509,7 @@ int circularBuffer_popFIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT
  * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_popFIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_popFIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
 
 /**
  * Copy one item from the end of \p p_buffer into \p p_data and remove it from \p p_buffer
@@ -252,7 +524,7 @@ int circularBuffer_popFIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRIC
  * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_popLIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_popLIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
 
 /**
  * Copy \p n items from the end of \p p_buffer into \p p_data and remove them
@@ -271,7 +543,7 @@ int circularBuffer_popLIFO(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT
  * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
  * @retval CIRC_BUF_NO_ERROR on success
  ******************************************************************************/
-int circularBuffer_popLIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_popLIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
 
 /**
  * Remove \p n items from the beginning of \p p_buffer. If \p n exceeds the number of items in
@@ -284,7 +556,41 @@ int circularBuffer_popLIFO_n(circularBuffer_t *p_buffer, void * FK_CB_KW_RESTRIC
  * @retval CIRC_BUF_NO_ERROR on success
  *
  ******************************************************************************/
-int circularBuffer_remove_records(circularBuffer_t *p_buffer, size_t n);
+FK_CB_API int circularBuffer_remove_records(circularBuffer_t *p_buffer, size_t n);
+
+/**
+ * Append \p n items that the caller has already written into the free slots
+ * following the last item, wrapping at the end of storage. This is the
+ * counterpart of circularBuffer_remove_records for writers that fill the
+ * buffer in place.
+ *
+ * @param[in] p_buffer pointer to circular buffer
+ * @param[in] n number of items to append
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_BUFFER_FULL if fewer than \p n slots are free
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+FK_CB_API int circularBuffer_add_records(circularBuffer_t *p_buffer, size_t n);
+
+/**
+ * Remove every item for which \p fp_keep returns false, wherever it is in the
+ * buffer. Surviving items are moved towards the beginning in one pass, keeping
+ * their order, and no scratch memory is used. Items before the first one
+ * removed are not copied.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] fp_keep called once per item, oldest first
+ * @param[in] p_context passed to \p fp_keep
+ * @param[out] p_removed number of items removed. May be `NULL`.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p fp_keep is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_filter(circularBuffer_t *p_buffer, circularBuffer_predicate_t fp_keep, void *p_context, size_t *p_removed, memcpy_t fp_memcpy);
 
 /**
  * Get number of slots in a circular buffer
@@ -295,13 +601,15 @@ int circularBuffer_remove_records(circularBuffer_t *p_buffer, size_t n);
  * @retval CIRC_BUF_NO_ERROR on success
  *
  ******************************************************************************/
-int circularBuffer_max_slots(const circularBuffer_t *p_buffer, size_t *result);
+FK_CB_API int circularBuffer_max_slots(const circularBuffer_t *p_buffer, size_t *result);
 
 /**
  * Copy \p src buffer into \p dst. \p src and \p dst must both have been
  * initialized with circularBuffer_init, and \p dst->p_data_location must be
  * at least as large as \p src->p_data_location. \p dst->p_data_location must
- * not overlap \p src->p_data_location
+ * not overlap \p src->p_data_location. Every slot of \p dst counts as
+ * written, so the next circularBuffer_sync from \p dst to a replica of it
+ * copies everything.
  *
  * @param[out] dst Pointer to destination buffer
  * @param[in] src Pointer to source buffer
@@ -312,7 +620,93 @@ int circularBuffer_max_slots(const circularBuffer_t *p_buffer, size_t *result);
  * @retval CIRC_BUF_NO_ERROR on success
  *
  ******************************************************************************/
-int circularBuffer_copy(circularBuffer_t *dst, const circularBuffer_t *src, memcpy_t fp_memcpy);
+FK_CB_API int circularBuffer_copy(circularBuffer_t *dst, const circularBuffer_t *src, memcpy_t fp_memcpy);
+
+/**
+ * Bring \p dst, a replica of \p src kept by this function, up to date with
+ * \p src. Only the slots written since the last sync are copied,
+ * using the count of items written that every buffer keeps, so the cost
+ * follows the write rate rather than the buffer size. A full copy is made the
+ * first time, if the geometry differs, or if at least a buffer's worth of
+ * items has been written since.
+ *
+ * Writes made through the core functions are tracked. Code that overwrites
+ * buffered items in place must add `buffer_slots` to \p src->write_seq so that
+ * the next sync copies everything. \p dst must not be changed other than by
+ * this function.
+ *
+ * @param[in,out] dst replica
+ * @param[in] src buffer being replicated
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p dst or \p src is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR as for circularBuffer_copy when a full copy is needed
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+FK_CB_API int circularBuffer_sync(circularBuffer_t *dst, const circularBuffer_t *src, memcpy_t fp_memcpy);
+
+/**
+ * Write a snapshot of \p p_buffer to \p fp_writer. The snapshot is a
+ * `CIRC_BUF_SERIAL_HEADER_SIZE` byte header (magic, version, item size, slot
+ * count and item count, little-endian) followed by the buffered items in FIFO
+ * order. Only the items in use are written, straight from the buffer's
+ * storage; \p p_buffer is not modified.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] fp_writer callback receiving the snapshot
+ * @param[in] p_context passed to \p fp_writer unchanged
+ * @param[in] chunk_size maximum number of item bytes handed to \p fp_writer
+ 	per call. 0 places no limit beyond the wrap point.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p fp_writer is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if \p fp_writer returns nonzero
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+FK_CB_API int circularBuffer_serialize(const circularBuffer_t *p_buffer, circularBuffer_writer_t fp_writer, void *p_context, size_t chunk_size);
+
+/**
+ * Restore a snapshot written by circularBuffer_serialize into \p p_buffer,
+ * replacing its contents. \p p_buffer must have been initialized with the same
+ * item size and enough slots for the snapshot's items; its slot count need not
+ * match. The items are stored unwrapped, starting at slot 0. On failure
+ * \p p_buffer is left empty.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] fp_reader callback supplying the snapshot
+ * @param[in] p_context passed to \p fp_reader unchanged
+ * @param[in] chunk_size maximum number of item bytes requested from
+ 	\p fp_reader per call. 0 places no limit.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer or \p fp_reader is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if \p fp_reader returns nonzero
+ * @retval CIRC_BUF_FORMAT_ERROR if the header is not a supported snapshot
+ * @retval CIRC_BUF_SIZE_ERROR if the item size differs or the items do not fit
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+FK_CB_API int circularBuffer_deserialize(circularBuffer_t *p_buffer, circularBuffer_reader_t fp_reader, void *p_context, size_t chunk_size);
+
+/**
+ * Register watermarks on \p p_buffer, replacing any registered before. From
+ * then on circularBuffer_push, circularBuffer_push_n, the pop functions and
+ * circularBuffer_remove_records record an event in \p p_watermark->events and
+ * call \p p_watermark->fp_callback when they move the count across
+ * \p p_watermark->high (upwards) or \p p_watermark->low (downwards). Operations
+ * that do not cross a watermark pay a single comparison; circularBuffer_flush,
+ * circularBuffer_copy and circularBuffer_deserialize never fire.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] p_watermark watermarks, which must stay valid while registered.
+ 	Its `events` field is cleared. Pass `NULL` to unregister.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR unless `low < high <= buffer_slots`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+FK_CB_API int circularBuffer_set_watermark(circularBuffer_t *p_buffer, circularBufferWatermark_t *p_watermark);
+
+#ifdef FK_CB_HEADER_ONLY
+#include "fk_circular_buffer.c"
+#endif
 
 #endif
 /*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,453 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer.hpp
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Typed C++ circular buffer
+ * @details Header-only C++17 counterpart of fk_circular_buffer.c, using the
+ * same start/count index scheme. Elements are constructed in place and moved
+ * rather than copied byte-wise, so non-trivial and move-only types are
+ * supported. `fk::ring<T, N>` holds its storage inline and has a constexpr
+ * capacity; `fk::ring<T>` uses caller-supplied storage. Bulk `std::span`
+ * operations are available when the standard library provides `<span>`.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_HPP_INCLUDED
+#define _CIRCULARBUFFER_HPP_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#if __has_include(<version>)
+#include <version>
+#endif
+#ifdef __cpp_lib_span
+#include <span>
+#endif
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+
+namespace fk {
+
+/** Capacity argument selecting caller-supplied storage */
+inline constexpr std::size_t dynamic_capacity = static_cast<std::size_t>(-1);
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+namespace detail {
+
+/** Inline storage for \p N elements */
+template <typename T, std::size_t N>
+class ring_storage {
+public:
+	static_assert(N > 0, "ring capacity must be non-zero");
+
+	/** Number of slots */
+	static constexpr std::size_t capacity() noexcept { return N; }
+
+protected:
+	ring_storage() noexcept = default;
+
+	T *slot(std::size_t index) noexcept
+	{
+		return std::launder(reinterpret_cast<T *>(m_data + index * sizeof(T)));
+	}
+
+	const T *slot(std::size_t index) const noexcept
+	{
+		return std::launder(reinterpret_cast<const T *>(m_data + index * sizeof(T)));
+	}
+
+private:
+	alignas(T) unsigned char m_data[N * sizeof(T)];
+};
+
+/** Caller-supplied storage */
+template <typename T>
+class ring_storage<T, dynamic_capacity> {
+public:
+	/** Number of slots */
+	std::size_t capacity() const noexcept { return m_slots; }
+
+protected:
+	ring_storage(void *p_storage, std::size_t storage_size) noexcept
+		: m_data(static_cast<unsigned char *>(p_storage)), m_slots(storage_size / sizeof(T))
+	{
+		assert(p_storage != nullptr && m_slots > 0);
+		assert(reinterpret_cast<std::uintptr_t>(p_storage) % alignof(T) == 0);
+	}
+
+	T *slot(std::size_t index) noexcept
+	{
+		return std::launder(reinterpret_cast<T *>(m_data + index * sizeof(T)));
+	}
+
+	const T *slot(std::size_t index) const noexcept
+	{
+		return std::launder(reinterpret_cast<const T *>(m_data + index * sizeof(T)));
+	}
+
+private:
+	unsigned char *m_data;
+	std::size_t m_slots;
+};
+
+} /* namespace detail */
+
+/**
+ * Circular buffer of \p T. Elements are addressed in FIFO order: index 0 is
+ * the oldest element, the one circularBuffer_popFIFO would return.
+ *
+ * Functions that have a `try_` counterpart require the buffer to be non-full
+ * (for insertion) or non-empty (for removal); this is checked with `assert`.
+ * A ring is neither copyable nor movable, since elements live at fixed
+ * addresses in its storage.
+ */
+template <typename T, std::size_t N = dynamic_capacity>
+class ring : public detail::ring_storage<T, N> {
+	using storage = detail::ring_storage<T, N>;
+
+	template <bool Const>
+	class basic_iterator;
+
+public:
+	using value_type = T;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = T &;
+	using const_reference = const T &;
+	using pointer = T *;
+	using const_pointer = const T *;
+	using iterator = basic_iterator<false>;
+	using const_iterator = basic_iterator<true>;
+	using reverse_iterator = std::reverse_iterator<iterator>;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+	/** Empty ring with inline storage */
+	ring() noexcept = default;
+
+	/**
+	 * Empty ring over caller-supplied storage. Only available for
+	 * `fk::ring<T>`.
+	 *
+	 * @param[in] p_storage uninitialized storage, aligned for \p T
+	 * @param[in] storage_size size of \p p_storage in bytes; bytes beyond the
+	 	last whole element are unused
+	 */
+	ring(void *p_storage, std::size_t storage_size) noexcept : storage(p_storage, storage_size) {}
+
+	ring(const ring &) = delete;
+	ring &operator=(const ring &) = delete;
+
+	~ring() { clear(); }
+
+	using storage::capacity;
+
+	/** Number of elements in use */
+	size_type size() const noexcept { return m_count; }
+
+	/** True if no elements are in use */
+	bool empty() const noexcept { return 0 == m_count; }
+
+	/** True if every slot is in use */
+	bool full() const noexcept { return capacity() == m_count; }
+
+	/**
+	 * Construct an element at the end
+	 *
+	 * @return reference to the new element
+	 */
+	template <typename... Args>
+	reference emplace_back(Args &&...args)
+	{
+		assert(!full());
+		T *p_item = ::new (static_cast<void *>(this->slot(wrap(m_start + m_count)))) T(std::forward<Args>(args)...);
+		m_count++;
+		return *p_item;
+	}
+
+	/** Copy \p value to the end */
+	void push_back(const T &value) { emplace_back(value); }
+
+	/** Move \p value to the end */
+	void push_back(T &&value) { emplace_back(std::move(value)); }
+
+	/**
+	 * Construct an element at the end if there is room
+	 *
+	 * @return false if the ring is full; \p args are left untouched
+	 */
+	template <typename... Args>
+	bool try_emplace_back(Args &&...args)
+	{
+		if (full()) {
+			return false;
+		}
+		emplace_back(std::forward<Args>(args)...);
+		return true;
+	}
+
+	/**
+	 * Copy or move \p value to the end if there is room
+	 *
+	 * @return false if the ring is full; \p value is left untouched
+	 */
+	template <typename U = T>
+	bool try_push(U &&value)
+	{
+		return try_emplace_back(std::forward<U>(value));
+	}
+
+	/** Destroy the oldest element */
+	void pop_front() noexcept
+	{
+		assert(!empty());
+		std::destroy_at(this->slot(m_start));
+		m_start = wrap(m_start + 1);
+		m_count--;
+	}
+
+	/** Destroy the newest element */
+	void pop_back() noexcept
+	{
+		assert(!empty());
+		m_count--;
+		std::destroy_at(this->slot(wrap(m_start + m_count)));
+	}
+
+	/**
+	 * Remove the oldest element, as circularBuffer_popFIFO
+	 *
+	 * @return the element, or `std::nullopt` if the ring is empty
+	 */
+	std::optional<T> try_pop()
+	{
+		std::optional<T> result;
+
+		if (!empty()) {
+			result.emplace(std::move(front()));
+			pop_front();
+		}
+		return result;
+	}
+
+	/**
+	 * Remove the newest element, as circularBuffer_popLIFO
+	 *
+	 * @return the element, or `std::nullopt` if the ring is empty
+	 */
+	std::optional<T> try_pop_back()
+	{
+		std::optional<T> result;
+
+		if (!empty()) {
+			result.emplace(std::move(back()));
+			pop_back();
+		}
+		return result;
+	}
+
+	/**
+	 * Remove up to \p n of the oldest elements, as circularBuffer_remove_records
+	 *
+	 * @return number of elements removed
+	 */
+	size_type remove(size_type n) noexcept
+	{
+		size_type removed = n < m_count ? n : m_count;
+
+		if constexpr (std::is_trivially_destructible_v<T>) {
+			m_start = wrap(m_start + removed);
+			m_count -= removed;
+		} else {
+			for (size_type i = 0; i < removed; i++) {
+				pop_front();
+			}
+		}
+		return removed;
+	}
+
+	/** Destroy every element */
+	void clear() noexcept
+	{
+		remove(m_count);
+		m_start = 0;
+	}
+
+	reference front() noexcept { return (*this)[0]; }
+	const_reference front() const noexcept { return (*this)[0]; }
+	reference back() noexcept { return (*this)[m_count - 1]; }
+	const_reference back() const noexcept { return (*this)[m_count - 1]; }
+
+	/** Element \p index, counting from the oldest */
+	reference operator[](size_type index) noexcept
+	{
+		assert(index < m_count);
+		return *this->slot(wrap(m_start + index));
+	}
+
+	const_reference operator[](size_type index) const noexcept
+	{
+		assert(index < m_count);
+		return *this->slot(wrap(m_start + index));
+	}
+
+#ifdef __cpp_lib_span
+	/**
+	 * Copy every element of \p items to the end, as circularBuffer_push_n
+	 *
+	 * @return false, copying nothing, if there is not room for all of \p items
+	 * @throws whatever copying a \p T throws; the ring is then left unchanged
+	 */
+	bool push(std::span<const T> items)
+	{
+		size_type first;
+		size_type end;
+
+		if (items.size() > capacity() - m_count) {
+			return false;
+		}
+		end = wrap(m_start + m_count);
+		first = capacity() - end < items.size() ? capacity() - end : items.size();
+		/* each call cleans up after itself; only the first run needs undoing */
+		std::uninitialized_copy_n(items.data(), first, this->slot(end));
+		try {
+			std::uninitialized_copy_n(items.data() + first, items.size() - first, this->slot(0));
+		} catch (...) {
+			std::destroy_n(this->slot(end), first);
+			throw;
+		}
+		m_count += items.size();
+		return true;
+	}
+
+	/**
+	 * Move the oldest elements into \p out, as circularBuffer_popFIFO_n
+	 *
+	 * @return number of elements moved: the smaller of size() and \p out.size()
+	 */
+	size_type pop(std::span<T> out)
+	{
+		size_type n = out.size() < m_count ? out.size() : m_count;
+		size_type first = capacity() - m_start < n ? capacity() - m_start : n;
+
+		std::move(this->slot(m_start), this->slot(m_start) + first, out.data());
+		std::move(this->slot(0), this->slot(0) + (n - first), out.data() + first);
+		remove(n);
+		return n;
+	}
+#endif
+
+	iterator begin() noexcept { return iterator(this, 0); }
+	iterator end() noexcept { return iterator(this, m_count); }
+	const_iterator begin() const noexcept { return const_iterator(this, 0); }
+	const_iterator end() const noexcept { return const_iterator(this, m_count); }
+	const_iterator cbegin() const noexcept { return begin(); }
+	const_iterator cend() const noexcept { return end(); }
+	reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+	reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+private:
+	/* position + count never exceeds twice the capacity, so one subtraction wraps */
+	size_type wrap(size_type position) const noexcept
+	{
+		return position >= capacity() ? position - capacity() : position;
+	}
+
+	size_type m_start = 0;
+	size_type m_count = 0;
+};
+
+/** Random-access iterator in FIFO order */
+template <typename T, std::size_t N>
+template <bool Const>
+class ring<T, N>::basic_iterator {
+	using owner = std::conditional_t<Const, const ring, ring>;
+
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using pointer = std::conditional_t<Const, const T *, T *>;
+	using reference = std::conditional_t<Const, const T &, T &>;
+
+	basic_iterator() noexcept = default;
+	basic_iterator(owner *p_ring, size_type index) noexcept : m_ring(p_ring), m_index(index) {}
+
+	/** Mutable to const conversion */
+	template <bool C = Const, typename = std::enable_if_t<C>>
+	basic_iterator(const basic_iterator<false> &other) noexcept : m_ring(other.m_ring), m_index(other.m_index) {}
+
+	reference operator*() const noexcept { return (*m_ring)[m_index]; }
+	pointer operator->() const noexcept { return &(*m_ring)[m_index]; }
+	reference operator[](difference_type n) const noexcept { return (*m_ring)[m_index + static_cast<size_type>(n)]; }
+
+	basic_iterator &operator++() noexcept { m_index++; return *this; }
+	basic_iterator &operator--() noexcept { m_index--; return *this; }
+	basic_iterator operator++(int) noexcept { basic_iterator old = *this; m_index++; return old; }
+	basic_iterator operator--(int) noexcept { basic_iterator old = *this; m_index--; return old; }
+	basic_iterator &operator+=(difference_type n) noexcept { m_index += static_cast<size_type>(n); return *this; }
+	basic_iterator &operator-=(difference_type n) noexcept { m_index -= static_cast<size_type>(n); return *this; }
+
+	friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept { return it += n; }
+	friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept { return it += n; }
+	friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept { return it -= n; }
+	friend difference_type operator-(const basic_iterator &a, const basic_iterator &b) noexcept
+	{
+		return static_cast<difference_type>(a.m_index) - static_cast<difference_type>(b.m_index);
+	}
+
+	friend bool operator==(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index == b.m_index; }
+	friend bool operator!=(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index != b.m_index; }
+	friend bool operator<(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index < b.m_index; }
+	friend bool operator>(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index > b.m_index; }
+	friend bool operator<=(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index <= b.m_index; }
+	friend bool operator>=(const basic_iterator &a, const basic_iterator &b) noexcept { return a.m_index >= b.m_index; }
+
+private:
+	friend class basic_iterator<!Const>;
+
+	owner *m_ring = nullptr;
+	size_type m_index = 0;
+};
+
+} /* namespace fk */
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,548 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_agg.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Numeric circular buffer with incrementally maintained aggregates
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_agg.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static size_t agg_item_size(circularBufferAggType_t type);
+static const uint8_t *agg_slot(const circularBufferAgg_t *p_agg, size_t slot);
+static double agg_value(const circularBufferAgg_t *p_agg, size_t slot);
+static bool agg_is_integer(const circularBufferAgg_t *p_agg);
+static int64_t agg_int_value(const circularBufferAgg_t *p_agg, size_t slot);
+static double agg_int_sum(const circularBufferAgg_t *p_agg);
+static double agg_abs(double value);
+static void agg_fsum_add(circularBufferAgg_t *p_agg, double value);
+static void agg_sum_add(circularBufferAgg_t *p_agg, size_t slot);
+static void agg_sum_remove(circularBufferAgg_t *p_agg, size_t slot);
+static int agg_compare(const circularBufferAgg_t *p_agg, size_t slot_a, size_t slot_b);
+static size_t deque_back(const circularBufferAggDeque_t *p_deque, size_t slots);
+static void agg_add_slot(circularBufferAgg_t *p_agg, size_t slot);
+static void agg_remove_slot(circularBufferAgg_t *p_agg, size_t slot);
+static void agg_remove_oldest(circularBufferAgg_t *p_agg, size_t n);
+static void agg_reset(circularBufferAgg_t *p_agg);
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferAgg_init(circularBufferAgg_t *p_agg, circularBufferAggType_t type, void *p_data_buffer, size_t data_buffer_size, size_t *p_index_buffer, size_t index_buffer_size)
+{
+	size_t item_size;
+	int ret;
+
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_index_buffer);
+
+	item_size = agg_item_size(type);
+	if (0 == item_size) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	ret = circularBuffer_init(&p_agg->buffer, p_data_buffer, data_buffer_size, item_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	if (index_buffer_size / sizeof(size_t) < CIRC_BUF_AGG_INDEX_ENTRIES(p_agg->buffer.buffer_slots)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_agg->type = type;
+	p_agg->min.p_index = p_index_buffer;
+	p_agg->max.p_index = p_index_buffer + p_agg->buffer.buffer_slots;
+	agg_reset(p_agg);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_flush(circularBufferAgg_t *p_agg)
+{
+	VERIFY_ADDR(p_agg);
+	circularBuffer_flush(&p_agg->buffer);
+	agg_reset(p_agg);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_push(circularBufferAgg_t *p_agg, const void *p_data)
+{
+	size_t slot;
+	int ret;
+
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_data);
+
+	slot = p_agg->buffer.end;
+	ret = circularBuffer_push(&p_agg->buffer, p_data, NULL);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+	agg_add_slot(p_agg, slot);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_push_n(circularBufferAgg_t *p_agg, const void *p_data, size_t n)
+{
+	size_t slot;
+	size_t i;
+	int ret;
+
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_data);
+
+	slot = p_agg->buffer.end;
+	ret = circularBuffer_push_n(&p_agg->buffer, p_data, n, NULL);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+	for (i = 0; i < n; i++) {
+		agg_add_slot(p_agg, slot);
+		slot++;
+		if (slot >= p_agg->buffer.buffer_slots) {
+			slot = 0;
+		}
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_push_overwrite(circularBufferAgg_t *p_agg, const void *p_data)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_data);
+
+	if (circularBuffer_is_full(&p_agg->buffer)) {
+		agg_remove_oldest(p_agg, 1);
+	}
+
+	return circularBufferAgg_push(p_agg, p_data);
+}
+
+int circularBufferAgg_popFIFO(circularBufferAgg_t *p_agg, void *p_data)
+{
+	VERIFY_ADDR(p_agg);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (p_data != NULL) {
+		circularBuffer_peek(&p_agg->buffer, p_data, 1, NULL);
+	}
+	agg_remove_oldest(p_agg, 1);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_popFIFO_n(circularBufferAgg_t *p_agg, void *p_data, size_t n)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_data);
+
+	if (n > p_agg->buffer.count) {
+		n = p_agg->buffer.count;
+	}
+	if (0 == n) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	circularBuffer_peek(&p_agg->buffer, p_data, n, NULL);
+	agg_remove_oldest(p_agg, n);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_remove_records(circularBufferAgg_t *p_agg, size_t n)
+{
+	VERIFY_ADDR(p_agg);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > p_agg->buffer.count) {
+		n = p_agg->buffer.count;
+	}
+	agg_remove_oldest(p_agg, n);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_sum(const circularBufferAgg_t *p_agg, double *result)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(result);
+
+	if (agg_is_integer(p_agg)) {
+		*result = agg_int_sum(p_agg);
+	} else {
+		*result = p_agg->sum + p_agg->sum_comp;
+	}
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_sum_int64(const circularBufferAgg_t *p_agg, int64_t *result)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(result);
+
+	if (!agg_is_integer(p_agg)) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	/* fits when the high word is the sign extension of the low word */
+	if (p_agg->sum_hi != ((p_agg->sum_lo >> 63) ? UINT64_MAX : 0)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	*result = (int64_t)p_agg->sum_lo;
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_mean(const circularBufferAgg_t *p_agg, double *result)
+{
+	double sum;
+
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(result);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	circularBufferAgg_sum(p_agg, &sum);
+	*result = sum / (double)p_agg->buffer.count;
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_variance(const circularBufferAgg_t *p_agg, double *result)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(result);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	*result = p_agg->m2 / (double)p_agg->samples;
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_min(const circularBufferAgg_t *p_agg, void *p_result)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_result);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	memcpy(p_result, agg_slot(p_agg, p_agg->min.p_index[p_agg->min.head]), p_agg->buffer.data_size);
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferAgg_max(const circularBufferAgg_t *p_agg, void *p_result)
+{
+	VERIFY_ADDR(p_agg);
+	VERIFY_ADDR(p_result);
+
+	if (0 == p_agg->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	memcpy(p_result, agg_slot(p_agg, p_agg->max.p_index[p_agg->max.head]), p_agg->buffer.data_size);
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static size_t agg_item_size(circularBufferAggType_t type)
+{
+	switch (type) {
+	case CIRC_BUF_AGG_INT32:
+		return sizeof(int32_t);
+	case CIRC_BUF_AGG_INT64:
+		return sizeof(int64_t);
+	case CIRC_BUF_AGG_FLOAT:
+		return sizeof(float);
+	case CIRC_BUF_AGG_DOUBLE:
+		return sizeof(double);
+	}
+	return 0;
+}
+
+static const uint8_t *agg_slot(const circularBufferAgg_t *p_agg, size_t slot)
+{
+	return p_agg->buffer.p_data_location + slot * p_agg->buffer.data_size;
+}
+
+static double agg_value(const circularBufferAgg_t *p_agg, size_t slot)
+{
+	int32_t i32;
+	int64_t i64;
+	float f;
+	double d;
+
+	switch (p_agg->type) {
+	case CIRC_BUF_AGG_INT32:
+		memcpy(&i32, agg_slot(p_agg, slot), sizeof(i32));
+		return (double)i32;
+	case CIRC_BUF_AGG_INT64:
+		memcpy(&i64, agg_slot(p_agg, slot), sizeof(i64));
+		return (double)i64;
+	case CIRC_BUF_AGG_FLOAT:
+		memcpy(&f, agg_slot(p_agg, slot), sizeof(f));
+		return (double)f;
+	case CIRC_BUF_AGG_DOUBLE:
+		memcpy(&d, agg_slot(p_agg, slot), sizeof(d));
+		return d;
+	}
+	return 0;
+}
+
+static bool agg_is_integer(const circularBufferAgg_t *p_agg)
+{
+	return CIRC_BUF_AGG_INT32 == p_agg->type || CIRC_BUF_AGG_INT64 == p_agg->type;
+}
+
+static int64_t agg_int_value(const circularBufferAgg_t *p_agg, size_t slot)
+{
+	int32_t i32;
+	int64_t i64;
+
+	if (CIRC_BUF_AGG_INT32 == p_agg->type) {
+		memcpy(&i32, agg_slot(p_agg, slot), sizeof(i32));
+		return i32;
+	}
+	memcpy(&i64, agg_slot(p_agg, slot), sizeof(i64));
+	return i64;
+}
+
+/* Round the 128-bit integer sum to the nearest representable double */
+static double agg_int_sum(const circularBufferAgg_t *p_agg)
+{
+	uint64_t lo = p_agg->sum_lo;
+	uint64_t hi = p_agg->sum_hi;
+	bool negative = (hi >> 63) != 0;
+	double value;
+
+	if (negative) {
+		lo = ~lo + 1;
+		hi = ~hi + (uint64_t)(0 == lo);
+	}
+	value = (double)hi * 18446744073709551616.0 + (double)lo;
+
+	return negative ? -value : value;
+}
+
+static double agg_abs(double value)
+{
+	return value < 0 ? -value : value;
+}
+
+/* Neumaier's variant of Kahan summation; removal adds the negated item */
+static void agg_fsum_add(circularBufferAgg_t *p_agg, double value)
+{
+	double total = p_agg->sum + value;
+
+	if (agg_abs(p_agg->sum) >= agg_abs(value)) {
+		p_agg->sum_comp += (p_agg->sum - total) + value;
+	} else {
+		p_agg->sum_comp += (value - total) + p_agg->sum;
+	}
+	p_agg->sum = total;
+}
+
+/*
+ * Integer items go into a two's complement 128-bit accumulator, which cannot
+ * overflow for any window of at most SIZE_MAX int64 items. Floating point items
+ * use Neumaier's compensated summation. Both also feed Welford's running mean
+ * and sum of squared deviations, from which the variance is read.
+ */
+static void agg_sum_add(circularBufferAgg_t *p_agg, size_t slot)
+{
+	double value = agg_value(p_agg, slot);
+	double delta;
+	int64_t item;
+
+	if (agg_is_integer(p_agg)) {
+		item = agg_int_value(p_agg, slot);
+		p_agg->sum_lo += (uint64_t)item;
+		p_agg->sum_hi += (uint64_t)(p_agg->sum_lo < (uint64_t)item) + (item < 0 ? UINT64_MAX : 0);
+	} else {
+		agg_fsum_add(p_agg, value);
+	}
+
+	p_agg->samples++;
+	delta = value - p_agg->mean;
+	p_agg->mean += delta / (double)p_agg->samples;
+	p_agg->m2 += delta * (value - p_agg->mean);
+}
+
+static void agg_sum_remove(circularBufferAgg_t *p_agg, size_t slot)
+{
+	double value = agg_value(p_agg, slot);
+	double delta;
+	int64_t item;
+	uint64_t borrow;
+
+	if (agg_is_integer(p_agg)) {
+		item = agg_int_value(p_agg, slot);
+		borrow = (uint64_t)(p_agg->sum_lo < (uint64_t)item);
+		p_agg->sum_lo -= (uint64_t)item;
+		p_agg->sum_hi -= borrow + (item < 0 ? UINT64_MAX : 0);
+	} else {
+		agg_fsum_add(p_agg, -value);
+	}
+
+	p_agg->samples--;
+	if (0 == p_agg->samples) {
+		p_agg->mean = 0;
+		p_agg->m2 = 0;
+		return;
+	}
+	delta = value - p_agg->mean;
+	p_agg->mean -= delta / (double)p_agg->samples;
+	p_agg->m2 -= delta * (value - p_agg->mean);
+	if (p_agg->m2 < 0) {
+		/* only the last-bit residue of an all-equal window can get here */
+		p_agg->m2 = 0;
+	}
+}
+
+/* Compared in the native type so that large int64 values keep their order */
+static int agg_compare(const circularBufferAgg_t *p_agg, size_t slot_a, size_t slot_b)
+{
+	int64_t a;
+	int64_t b;
+	int32_t a32;
+	int32_t b32;
+	double da;
+	double db;
+
+	switch (p_agg->type) {
+	case CIRC_BUF_AGG_INT32:
+		memcpy(&a32, agg_slot(p_agg, slot_a), sizeof(a32));
+		memcpy(&b32, agg_slot(p_agg, slot_b), sizeof(b32));
+		return (a32 > b32) - (a32 < b32);
+	case CIRC_BUF_AGG_INT64:
+		memcpy(&a, agg_slot(p_agg, slot_a), sizeof(a));
+		memcpy(&b, agg_slot(p_agg, slot_b), sizeof(b));
+		return (a > b) - (a < b);
+	case CIRC_BUF_AGG_FLOAT:
+	case CIRC_BUF_AGG_DOUBLE:
+		da = agg_value(p_agg, slot_a);
+		db = agg_value(p_agg, slot_b);
+		return (da > db) - (da < db);
+	}
+	return 0;
+}
+
+static size_t deque_back(const circularBufferAggDeque_t *p_deque, size_t slots)
+{
+	return p_deque->p_index[(p_deque->head + p_deque->count - 1) % slots];
+}
+
+static void agg_add_slot(circularBufferAgg_t *p_agg, size_t slot)
+{
+	size_t slots = p_agg->buffer.buffer_slots;
+
+	agg_sum_add(p_agg, slot);
+
+	/* drop entries that can never be the minimum/maximum again */
+	while (p_agg->min.count > 0 && agg_compare(p_agg, deque_back(&p_agg->min, slots), slot) > 0) {
+		p_agg->min.count--;
+	}
+	p_agg->min.p_index[(p_agg->min.head + p_agg->min.count) % slots] = slot;
+	p_agg->min.count++;
+
+	while (p_agg->max.count > 0 && agg_compare(p_agg, deque_back(&p_agg->max, slots), slot) < 0) {
+		p_agg->max.count--;
+	}
+	p_agg->max.p_index[(p_agg->max.head + p_agg->max.count) % slots] = slot;
+	p_agg->max.count++;
+}
+
+static void agg_remove_slot(circularBufferAgg_t *p_agg, size_t slot)
+{
+	size_t slots = p_agg->buffer.buffer_slots;
+
+	agg_sum_remove(p_agg, slot);
+
+	if (p_agg->min.count > 0 && p_agg->min.p_index[p_agg->min.head] == slot) {
+		p_agg->min.head = (p_agg->min.head + 1) % slots;
+		p_agg->min.count--;
+	}
+	if (p_agg->max.count > 0 && p_agg->max.p_index[p_agg->max.head] == slot) {
+		p_agg->max.head = (p_agg->max.head + 1) % slots;
+		p_agg->max.count--;
+	}
+}
+
+static void agg_remove_oldest(circularBufferAgg_t *p_agg, size_t n)
+{
+	size_t slot = p_agg->buffer.start;
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		agg_remove_slot(p_agg, slot);
+		slot++;
+		if (slot >= p_agg->buffer.buffer_slots) {
+			slot = 0;
+		}
+	}
+	circularBuffer_remove_records(&p_agg->buffer, n);
+
+	if (0 == p_agg->buffer.count) {
+		/* drop any residual floating point error along with the data */
+		agg_reset(p_agg);
+	}
+}
+
+static void agg_reset(circularBufferAgg_t *p_agg)
+{
+	p_agg->sum_lo = 0;
+	p_agg->sum_hi = 0;
+	p_agg->sum = 0;
+	p_agg->sum_comp = 0;
+	p_agg->samples = 0;
+	p_agg->mean = 0;
+	p_agg->m2 = 0;
+	p_agg->min.head = 0;
+	p_agg->min.count = 0;
+	p_agg->max.head = 0;
+	p_agg->max.count = 0;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
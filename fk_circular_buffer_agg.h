@@ -0,0 +1,253 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_agg.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Numeric circular buffer with incrementally maintained aggregates
+ * @details Integer items are summed exactly in a 128-bit accumulator and
+ * floating point items with Neumaier-compensated summation, so removing an
+ * item from the window removes it from the sum without leaving rounding
+ * error behind. Variance is kept with Welford's add/remove updates rather
+ * than from a sum of squares. Minimum and maximum are kept in monotonic
+ * deques of slot indices stored in a caller-supplied array, so every
+ * statistic is available in O(1) and each push/pop costs amortized O(1).<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_AGG_INCLUDED
+#define _CIRCULARBUFFER_AGG_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+
+/** Number of `size_t` entries required in the index buffer for \p slots slots */
+#define CIRC_BUF_AGG_INDEX_ENTRIES(slots) (2 * (slots))
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Element type stored in an aggregate buffer */
+typedef enum circularBufferAggType{
+	CIRC_BUF_AGG_INT32,  /**< `int32_t` items */
+	CIRC_BUF_AGG_INT64,  /**< `int64_t` items */
+	CIRC_BUF_AGG_FLOAT,  /**< `float` items */
+	CIRC_BUF_AGG_DOUBLE  /**< `double` items */
+} circularBufferAggType_t;
+
+/** Monotonic deque of slot indices */
+typedef struct circularBufferAggDeque{
+	size_t *p_index; /**< Index storage, one entry per buffer slot */
+	size_t head; /**< Position of the front entry in \p p_index */
+	size_t count; /**< Entries in use */
+} circularBufferAggDeque_t;
+
+/** Circular buffer with running aggregates */
+typedef struct circularBufferAgg{
+	circularBuffer_t buffer; /**< Underlying buffer holding the samples */
+	circularBufferAggType_t type; /**< Element type */
+	uint64_t sum_lo; /**< Low 64 bits of the exact sum of integer items */
+	uint64_t sum_hi; /**< High 64 bits (two's complement) of the exact sum of integer items */
+	double sum; /**< Compensated sum of floating point items */
+	double sum_comp; /**< Neumaier compensation term of \p sum */
+	size_t samples; /**< Items folded into \p mean and \p m2 */
+	double mean; /**< Running mean (Welford) */
+	double m2; /**< Running sum of squared deviations from \p mean (Welford) */
+	circularBufferAggDeque_t min; /**< Slots in non-decreasing value order */
+	circularBufferAggDeque_t max; /**< Slots in non-increasing value order */
+} circularBufferAgg_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize an aggregate buffer
+ *
+ * @param[in] p_agg pointer to the aggregate buffer to initialize
+ * @param[in] type element type; determines the item size
+ * @param[in] p_data_buffer pointer to the memory where the items will be stored
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes. Must be evenly
+ *								divisible by the size of \p type
+ * @param[in] p_index_buffer pointer to memory used for the min/max deques
+ * @param[in] index_buffer_size size of \p p_index_buffer in bytes. Must hold at
+ *								least `CIRC_BUF_AGG_INDEX_ENTRIES(slots)` `size_t` entries
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_index_buffer is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p type is unknown, if \p data_buffer_size is
+ *								invalid, or if \p index_buffer_size is too small
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferAgg_init(circularBufferAgg_t *p_agg, circularBufferAggType_t type, void *p_data_buffer, size_t data_buffer_size, size_t *p_index_buffer, size_t index_buffer_size);
+
+/**
+ * Flush (empty) an aggregate buffer and reset its aggregates
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferAgg_flush(circularBufferAgg_t *p_agg);
+
+/**
+ * Push 1 item onto the end of \p p_agg and fold it into the aggregates
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[in] p_data pointer to one item of the buffer's type
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_agg is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_push(circularBufferAgg_t *p_agg, const void *p_data);
+
+/**
+ * Push \p n items onto the end of \p p_agg and fold them into the aggregates
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[in] p_data pointer to \p n items of the buffer's type
+ * @param[in] n number of items to push
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the slot count
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_agg cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_push_n(circularBufferAgg_t *p_agg, const void *p_data, size_t n);
+
+/**
+ * Push 1 item, first removing the oldest item if \p p_agg is full. This is the
+ * usual sliding-window update.
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[in] p_data pointer to one item of the buffer's type
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_data is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_push_overwrite(circularBufferAgg_t *p_agg, const void *p_data);
+
+/**
+ * Copy the oldest item into \p p_data and remove it from \p p_agg
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] p_data destination for one item. May be `NULL` to discard it.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_popFIFO(circularBufferAgg_t *p_agg, void *p_data);
+
+/**
+ * Copy the \p n oldest items into \p p_data and remove them from \p p_agg. If
+ * \p n exceeds the item count, all items are popped.
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] p_data destination for \p n items
+ * @param[in] n number of items to pop
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_popFIFO_n(circularBufferAgg_t *p_agg, void *p_data, size_t n);
+
+/**
+ * Remove the \p n oldest items from \p p_agg. If \p n exceeds the item count,
+ * all items are removed.
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_remove_records(circularBufferAgg_t *p_agg, size_t n);
+
+/**
+ * Get the sum of the items in \p p_agg
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] result sum of the items; 0 if empty
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_sum(const circularBufferAgg_t *p_agg, double *result);
+
+/**
+ * Get the exact sum of the items in an integer aggregate buffer
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] result sum of the items; 0 if empty
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p result is `NULL`
+ * @retval CIRC_BUF_FORMAT_ERROR if \p p_agg does not hold integer items
+ * @retval CIRC_BUF_SIZE_ERROR if the sum does not fit in an `int64_t`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_sum_int64(const circularBufferAgg_t *p_agg, int64_t *result);
+
+/**
+ * Get the arithmetic mean of the items in \p p_agg
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] result mean of the items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p result is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_mean(const circularBufferAgg_t *p_agg, double *result);
+
+/**
+ * Get the population variance of the items in \p p_agg
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] result variance of the items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p result is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_variance(const circularBufferAgg_t *p_agg, double *result);
+
+/**
+ * Copy the smallest item in \p p_agg into \p p_result
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] p_result destination for one item of the buffer's type
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_result is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_min(const circularBufferAgg_t *p_agg, void *p_result);
+
+/**
+ * Copy the largest item in \p p_agg into \p p_result
+ *
+ * @param[in] p_agg pointer to the aggregate buffer
+ * @param[out] p_result destination for one item of the buffer's type
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_agg or \p p_result is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_agg is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferAgg_max(const circularBufferAgg_t *p_agg, void *p_result);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
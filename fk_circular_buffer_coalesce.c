@@ -0,0 +1,262 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_coalesce.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer that keeps only the latest item per key
+ * @details Index entries are removed with backward-shift deletion, so the
+ * table never accumulates tombstones.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_coalesce.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static const uint8_t *coalesce_slot(const circularBufferCoalesce_t *p_coalesce, size_t slot);
+static size_t coalesce_home(const circularBufferCoalesce_t *p_coalesce, const uint8_t *p_item);
+static size_t coalesce_find(const circularBufferCoalesce_t *p_coalesce, const uint8_t *p_item);
+static void coalesce_forget(circularBufferCoalesce_t *p_coalesce, size_t n);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferCoalesce_init(circularBufferCoalesce_t *p_coalesce, void *p_data_buffer, size_t data_buffer_size, size_t item_size, size_t key_offset, size_t key_size, size_t *p_index, size_t index_size)
+{
+	size_t entries;
+	int ret;
+
+	VERIFY_ADDR(p_coalesce);
+	VERIFY_ADDR(p_index);
+	VERIFY_SIZE(key_size);
+
+	ret = circularBuffer_init(&p_coalesce->buffer, p_data_buffer, data_buffer_size, item_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+	if (key_offset > item_size || key_size > item_size - key_offset) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	entries = index_size / sizeof(size_t);
+	if (entries <= p_coalesce->buffer.buffer_slots || (entries & (entries - 1)) != 0) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_coalesce->key_offset = key_offset;
+	p_coalesce->key_size = key_size;
+	p_coalesce->p_index = p_index;
+	p_coalesce->index_mask = entries - 1;
+
+	return circularBufferCoalesce_flush(p_coalesce);
+}
+
+int circularBufferCoalesce_flush(circularBufferCoalesce_t *p_coalesce)
+{
+	size_t i;
+
+	VERIFY_ADDR(p_coalesce);
+
+	for (i = 0; i <= p_coalesce->index_mask; i++) {
+		p_coalesce->p_index[i] = CIRC_BUF_COALESCE_UNUSED;
+	}
+
+	return circularBuffer_flush(&p_coalesce->buffer);
+}
+
+int circularBufferCoalesce_push(circularBufferCoalesce_t *p_coalesce, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	size_t entry;
+	size_t slot;
+	int ret;
+
+	VERIFY_ADDR(p_coalesce);
+	VERIFY_ADDR(p_data);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	entry = coalesce_find(p_coalesce, p_data);
+	slot = p_coalesce->p_index[entry];
+	if (slot != CIRC_BUF_COALESCE_UNUSED) {
+		fp_memcpy(p_coalesce->buffer.p_data_location + slot * p_coalesce->buffer.data_size, p_data, p_coalesce->buffer.data_size);
+		/* not a write at the tail, so circularBuffer_sync must copy everything */
+		p_coalesce->buffer.write_seq += p_coalesce->buffer.buffer_slots;
+		return CIRC_BUF_NO_ERROR;
+	}
+
+	slot = p_coalesce->buffer.end;
+	ret = circularBuffer_push(&p_coalesce->buffer, p_data, fp_memcpy);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		p_coalesce->p_index[entry] = slot;
+	}
+	return ret;
+}
+
+int circularBufferCoalesce_popFIFO(circularBufferCoalesce_t *p_coalesce, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_coalesce);
+	VERIFY_ADDR(p_data);
+
+	if (0 == p_coalesce->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	coalesce_forget(p_coalesce, 1);
+	return circularBuffer_popFIFO(&p_coalesce->buffer, p_data, fp_memcpy);
+}
+
+int circularBufferCoalesce_popFIFO_n(circularBufferCoalesce_t *p_coalesce, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_coalesce);
+	VERIFY_ADDR(p_data);
+
+	if (0 == p_coalesce->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	VERIFY_SIZE(n);
+
+	coalesce_forget(p_coalesce, n);
+	return circularBuffer_popFIFO_n(&p_coalesce->buffer, p_data, n, fp_memcpy);
+}
+
+int circularBufferCoalesce_remove_records(circularBufferCoalesce_t *p_coalesce, size_t n)
+{
+	VERIFY_ADDR(p_coalesce);
+
+	if (0 == p_coalesce->buffer.count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	coalesce_forget(p_coalesce, n);
+	return circularBuffer_remove_records(&p_coalesce->buffer, n);
+}
+
+int circularBufferCoalesce_peek_key(const circularBufferCoalesce_t *p_coalesce, const void *p_key_item, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	size_t slot;
+
+	VERIFY_ADDR(p_coalesce);
+	VERIFY_ADDR(p_key_item);
+	VERIFY_ADDR(p_data);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	slot = p_coalesce->p_index[coalesce_find(p_coalesce, p_key_item)];
+	if (CIRC_BUF_COALESCE_UNUSED == slot) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	fp_memcpy(p_data, coalesce_slot(p_coalesce, slot), p_coalesce->buffer.data_size);
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static const uint8_t *coalesce_slot(const circularBufferCoalesce_t *p_coalesce, size_t slot)
+{
+	return p_coalesce->buffer.p_data_location + slot * p_coalesce->buffer.data_size;
+}
+
+/* FNV-1a over the key bytes */
+static size_t coalesce_home(const circularBufferCoalesce_t *p_coalesce, const uint8_t *p_item)
+{
+	const uint8_t *p_key = p_item + p_coalesce->key_offset;
+	uint64_t hash = UINT64_C(14695981039346656037);
+	size_t i;
+
+	for (i = 0; i < p_coalesce->key_size; i++) {
+		hash ^= p_key[i];
+		hash *= UINT64_C(1099511628211);
+	}
+	return (size_t)(hash ^ (hash >> 32)) & p_coalesce->index_mask;
+}
+
+/*
+ * Index entry holding the key of \p p_item, or the unused entry where it
+ * would be inserted. The table always has a free entry, so this terminates.
+ */
+static size_t coalesce_find(const circularBufferCoalesce_t *p_coalesce, const uint8_t *p_item)
+{
+	size_t entry = coalesce_home(p_coalesce, p_item);
+	size_t slot;
+
+	for (;;) {
+		slot = p_coalesce->p_index[entry];
+		if (CIRC_BUF_COALESCE_UNUSED == slot) {
+			return entry;
+		}
+		if (0 == memcmp(coalesce_slot(p_coalesce, slot) + p_coalesce->key_offset, p_item + p_coalesce->key_offset, p_coalesce->key_size)) {
+			return entry;
+		}
+		entry = (entry + 1) & p_coalesce->index_mask;
+	}
+}
+
+/* Drop the index entries of the oldest \p n items, which are still in place */
+static void coalesce_forget(circularBufferCoalesce_t *p_coalesce, size_t n)
+{
+	size_t slot = p_coalesce->buffer.start;
+	size_t hole;
+	size_t next;
+	size_t home;
+
+	if (n > p_coalesce->buffer.count) {
+		n = p_coalesce->buffer.count;
+	}
+
+	while (n--) {
+		hole = coalesce_find(p_coalesce, coalesce_slot(p_coalesce, slot));
+
+		/* shift back any later entry of the probe run that may not skip the hole */
+		next = hole;
+		for (;;) {
+			next = (next + 1) & p_coalesce->index_mask;
+			if (CIRC_BUF_COALESCE_UNUSED == p_coalesce->p_index[next]) {
+				break;
+			}
+			home = coalesce_home(p_coalesce, coalesce_slot(p_coalesce, p_coalesce->p_index[next]));
+			if (((next - home) & p_coalesce->index_mask) >= ((next - hole) & p_coalesce->index_mask)) {
+				p_coalesce->p_index[hole] = p_coalesce->p_index[next];
+				hole = next;
+			}
+		}
+		p_coalesce->p_index[hole] = CIRC_BUF_COALESCE_UNUSED;
+
+		slot++;
+		if (slot >= p_coalesce->buffer.buffer_slots) {
+			slot = 0;
+		}
+	}
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_coalesce.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer that keeps only the latest item per key
+ * @details Each item carries a key of fixed size at a fixed offset. A linear
+ * probing hash index in a caller-supplied array maps each queued key to its
+ * slot; pushing an item whose key is already queued overwrites that item in
+ * place, keeping its position in the queue, instead of appending. The number
+ * of queued items is therefore bounded by the number of distinct keys.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_COALESCE_INCLUDED
+#define _CIRCULARBUFFER_COALESCE_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Marks an unused index entry */
+#define CIRC_BUF_COALESCE_UNUSED SIZE_MAX
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Coalescing circular buffer */
+typedef struct circularBufferCoalesce{
+	circularBuffer_t buffer; /**< Underlying buffer */
+	size_t key_offset; /**< Offset of the key within an item */
+	size_t key_size; /**< Size of the key in bytes */
+	size_t *p_index; /**< Hash index of slot numbers */
+	size_t index_mask; /**< Number of index entries minus one */
+} circularBufferCoalesce_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize a coalescing buffer
+ *
+ * @param[in] p_coalesce pointer to the buffer to initialize
+ * @param[in] p_data_buffer pointer to the storage for the items
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size. \p data_buffer_size must be evenly divisible by
+ *								\p item_size
+ * @param[in] key_offset offset of the key within each item
+ * @param[in] key_size size of the key in bytes
+ * @param[in] p_index storage for the hash index
+ * @param[in] index_size size of \p p_index in bytes. The number of entries
+ *								must be a power of two greater than the number
+ *								of slots; twice the number of slots or more
+ *								keeps probes short.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce or \p p_index is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR as for circularBuffer_init, if the key does not
+ *								fit in an item, or if \p index_size is unsuitable
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCoalesce_init(circularBufferCoalesce_t *p_coalesce, void *p_data_buffer, size_t data_buffer_size, size_t item_size, size_t key_offset, size_t key_size, size_t *p_index, size_t index_size);
+
+/**
+ * Empty the buffer and its index
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_flush(circularBufferCoalesce_t *p_coalesce);
+
+/**
+ * Push 1 item, or overwrite the queued item with the same key
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @param[in] p_data pointer to one item
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if the key is not queued and the buffer is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_push(circularBufferCoalesce_t *p_coalesce, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the oldest item into \p p_data and remove it, along with its key in
+ * the index, as circularBuffer_popFIFO does
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @param[out] p_data destination for one item. Must not overlap the buffer's
+ 	storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_popFIFO(circularBufferCoalesce_t *p_coalesce, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy up to \p n of the oldest items into \p p_data and remove them, along
+ * with their keys in the index, as circularBuffer_popFIFO_n does. If \p n
+ * exceeds the number of items, all of them are popped.
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @param[out] p_data destination for \p n items. Must not overlap the buffer's
+ 	storage.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_popFIFO_n(circularBufferCoalesce_t *p_coalesce, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Remove up to \p n of the oldest items, along with their keys in the index,
+ * as circularBuffer_remove_records does. If \p n exceeds the number of items,
+ * all of them are removed.
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_remove_records(circularBufferCoalesce_t *p_coalesce, size_t n);
+
+/**
+ * Copy the queued item whose key matches the key in \p p_key_item
+ *
+ * @param[in] p_coalesce pointer to the buffer
+ * @param[in] p_key_item an item, of which only the key is read
+ * @param[out] p_data destination for one item
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_coalesce, \p p_key_item or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if no queued item has that key
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCoalesce_peek_key(const circularBufferCoalesce_t *p_coalesce, const void *p_key_item, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
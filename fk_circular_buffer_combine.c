@@ -0,0 +1,255 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_combine.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Flat-combining front end for sharing a buffer between threads
+ * @details Follows Hendler, Incze, Shavit and Tzafrir, "Flat Combining and
+ * the Synchronization-Parallelism Tradeoff" (SPAA 2010), with a fixed array of
+ * publication slots instead of a dynamic list.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_combine.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static bool combine_attached(const circularBufferCombine_t *p_combine, size_t slot);
+static int combine_request(circularBufferCombine_t *p_combine, size_t slot, unsigned int op);
+static void combine_run(circularBufferCombine_t *p_combine);
+static void combine_apply(circularBufferCombine_t *p_combine);
+static void combine_pause(void);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferCombine_init(circularBufferCombine_t *p_combine, void *p_data_buffer, size_t data_buffer_size, size_t item_size, circularBufferCombineSlot_t *p_slots, size_t slot_count, memcpy_t fp_memcpy)
+{
+	size_t i;
+	int ret;
+
+	VERIFY_ADDR(p_combine);
+	VERIFY_ADDR(p_slots);
+	VERIFY_SIZE(slot_count);
+
+	ret = circularBuffer_init(&p_combine->buffer, p_data_buffer, data_buffer_size, item_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+	if (pthread_mutex_init(&p_combine->lock, NULL) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	for (i = 0; i < slot_count; i++) {
+		atomic_init(&p_slots[i].state, CIRC_BUF_COMBINE_FREE);
+	}
+	p_combine->p_slots = p_slots;
+	p_combine->slot_count = slot_count;
+	p_combine->fp_memcpy = fp_memcpy;
+	atomic_init(&p_combine->combining, false);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferCombine_destroy(circularBufferCombine_t *p_combine)
+{
+	VERIFY_ADDR(p_combine);
+
+	pthread_mutex_destroy(&p_combine->lock);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferCombine_attach(circularBufferCombine_t *p_combine, size_t *p_slot)
+{
+	unsigned int expected;
+	size_t i;
+
+	VERIFY_ADDR(p_combine);
+	VERIFY_ADDR(p_slot);
+
+	for (i = 0; i < p_combine->slot_count; i++) {
+		expected = CIRC_BUF_COMBINE_FREE;
+		if (atomic_compare_exchange_strong_explicit(&p_combine->p_slots[i].state, &expected, CIRC_BUF_COMBINE_IDLE, memory_order_acquire, memory_order_relaxed)) {
+			*p_slot = i;
+			return CIRC_BUF_NO_ERROR;
+		}
+	}
+
+	return CIRC_BUF_BUFFER_FULL;
+}
+
+int circularBufferCombine_detach(circularBufferCombine_t *p_combine, size_t slot)
+{
+	VERIFY_ADDR(p_combine);
+
+	if (!combine_attached(p_combine, slot)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	atomic_store_explicit(&p_combine->p_slots[slot].state, CIRC_BUF_COMBINE_FREE, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferCombine_push_n(circularBufferCombine_t *p_combine, size_t slot, const void *p_data, size_t n)
+{
+	VERIFY_ADDR(p_combine);
+
+	if (!combine_attached(p_combine, slot)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_combine->p_slots[slot].p_push = p_data;
+	p_combine->p_slots[slot].n = n;
+	return combine_request(p_combine, slot, CIRC_BUF_COMBINE_PUSH);
+}
+
+int circularBufferCombine_popFIFO_n(circularBufferCombine_t *p_combine, size_t slot, void *p_data, size_t n, size_t *p_popped)
+{
+	int ret;
+
+	VERIFY_ADDR(p_combine);
+
+	if (!combine_attached(p_combine, slot)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_combine->p_slots[slot].p_pop = p_data;
+	p_combine->p_slots[slot].n = n;
+	ret = combine_request(p_combine, slot, CIRC_BUF_COMBINE_POP);
+	if (p_popped != NULL) {
+		*p_popped = p_combine->p_slots[slot].done;
+	}
+
+	return ret;
+}
+
+int circularBufferCombine_getCount(circularBufferCombine_t *p_combine, size_t *result)
+{
+	int ret;
+
+	VERIFY_ADDR(p_combine);
+	VERIFY_ADDR(result);
+
+	pthread_mutex_lock(&p_combine->lock);
+	ret = circularBuffer_getCount(&p_combine->buffer, result);
+	pthread_mutex_unlock(&p_combine->lock);
+
+	return ret;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static bool combine_attached(const circularBufferCombine_t *p_combine, size_t slot)
+{
+	return slot < p_combine->slot_count
+		&& atomic_load_explicit(&p_combine->p_slots[slot].state, memory_order_relaxed) == CIRC_BUF_COMBINE_IDLE;
+}
+
+/* publish a request and wait until some combiner, possibly this thread, applies it */
+static int combine_request(circularBufferCombine_t *p_combine, size_t slot, unsigned int op)
+{
+	circularBufferCombineSlot_t *p_slot = &p_combine->p_slots[slot];
+	size_t spins;
+
+	atomic_store_explicit(&p_slot->state, op, memory_order_release);
+
+	for (spins = 0; spins < CIRC_BUF_COMBINE_SPINS; spins++) {
+		if (atomic_load_explicit(&p_slot->state, memory_order_acquire) == CIRC_BUF_COMBINE_IDLE) {
+			return p_slot->result;
+		}
+		/* while a combiner runs it will most likely pick this request up */
+		if (!atomic_load_explicit(&p_combine->combining, memory_order_relaxed)
+			&& 0 == pthread_mutex_trylock(&p_combine->lock)) {
+			combine_run(p_combine);
+			pthread_mutex_unlock(&p_combine->lock);
+			return p_slot->result;
+		}
+		combine_pause();
+	}
+
+	pthread_mutex_lock(&p_combine->lock);
+	if (atomic_load_explicit(&p_slot->state, memory_order_acquire) != CIRC_BUF_COMBINE_IDLE) {
+		combine_run(p_combine);
+	}
+	pthread_mutex_unlock(&p_combine->lock);
+
+	return p_slot->result;
+}
+
+/* combine with the lock held, flagging it to the spinning threads */
+static void combine_run(circularBufferCombine_t *p_combine)
+{
+	atomic_store_explicit(&p_combine->combining, true, memory_order_relaxed);
+	combine_apply(p_combine);
+	atomic_store_explicit(&p_combine->combining, false, memory_order_relaxed);
+}
+
+/* apply every pending request; called with the lock held */
+static void combine_apply(circularBufferCombine_t *p_combine)
+{
+	circularBufferCombineSlot_t *p_slot;
+	size_t count;
+	size_t i;
+
+	for (i = 0; i < p_combine->slot_count; i++) {
+		p_slot = &p_combine->p_slots[i];
+		switch (atomic_load_explicit(&p_slot->state, memory_order_acquire)) {
+		case CIRC_BUF_COMBINE_PUSH:
+			p_slot->result = circularBuffer_push_n(&p_combine->buffer, p_slot->p_push, p_slot->n, p_combine->fp_memcpy);
+			break;
+		case CIRC_BUF_COMBINE_POP:
+			count = p_combine->buffer.count;
+			p_slot->result = circularBuffer_popFIFO_n(&p_combine->buffer, p_slot->p_pop, p_slot->n, p_combine->fp_memcpy);
+			p_slot->done = count - p_combine->buffer.count;
+			break;
+		default:
+			continue;
+		}
+		atomic_store_explicit(&p_slot->state, CIRC_BUF_COMBINE_IDLE, memory_order_release);
+	}
+}
+
+/* tell the core this is a spin-wait loop */
+static void combine_pause(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_ia32_pause();
+#elif defined(__GNUC__) && defined(__aarch64__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
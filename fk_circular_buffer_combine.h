@@ -0,0 +1,170 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_combine.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Flat-combining front end for sharing a buffer between threads
+ * @details Each thread attaches to a slot of its own and publishes its push
+ * and pop requests there. Whichever thread takes the lock becomes the
+ * combiner: it applies every published request, one at a time in slot order,
+ * with circularBuffer_push_n or circularBuffer_popFIFO_n, and marks each one
+ * done. Requests are not merged, so a batch of single-item pushes costs one
+ * push_n call each, but the buffer stays in the combiner's cache throughout.
+ * Other threads spin briefly on their own slot, and only try the lock when no
+ * combiner is running, so they leave the lock's cache line alone. A thread
+ * whose request is not picked up within `CIRC_BUF_COMBINE_SPINS` checks
+ * blocks on the lock and combines itself.<br>
+ * Watermark callbacks run on the combining thread, with the lock held.<br>
+ * Requires a C11 compiler with `<stdatomic.h>` and POSIX threads.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_COMBINE_INCLUDED
+#define _CIRCULARBUFFER_COMBINE_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Cache line size assumed when separating the slots */
+#define CIRC_BUF_COMBINE_CACHE_LINE 64
+/** Checks of its own slot a thread makes before blocking on the lock */
+#define CIRC_BUF_COMBINE_SPINS 128
+
+/** Slot states */
+#define CIRC_BUF_COMBINE_FREE 0u /**< Not attached */
+#define CIRC_BUF_COMBINE_IDLE 1u /**< Attached, no request pending */
+#define CIRC_BUF_COMBINE_PUSH 2u /**< Push request pending */
+#define CIRC_BUF_COMBINE_POP 3u /**< Pop request pending */
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Per-thread publication slot; each occupies its own cache line */
+typedef struct circularBufferCombineSlot{
+	_Alignas(CIRC_BUF_COMBINE_CACHE_LINE) _Atomic unsigned int state; /**< `CIRC_BUF_COMBINE_*` */
+	int result; /**< Result of the last request */
+	const void *p_push; /**< Items to push */
+	void *p_pop; /**< Destination for popped items */
+	size_t n; /**< Items requested */
+	size_t done; /**< Items popped */
+} circularBufferCombineSlot_t;
+
+/** Flat-combining buffer */
+typedef struct circularBufferCombine{
+	circularBuffer_t buffer; /**< Underlying buffer; only touched by the combiner */
+	circularBufferCombineSlot_t *p_slots; /**< Publication slots */
+	size_t slot_count; /**< Number of slots */
+	memcpy_t fp_memcpy; /**< Copy routine used for every request */
+	pthread_mutex_t lock; /**< Held by the combiner */
+	_Atomic bool combining; /**< Set while a combiner holds the lock */
+} circularBufferCombine_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize a flat-combining buffer. Arguments are as for circularBuffer_init,
+ * plus the slots.
+ *
+ * @param[out] p_combine buffer to initialize
+ * @param[in] p_data_buffer pointer to the storage
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size
+ * @param[in] p_slots one slot per thread that may attach at once
+ * @param[in] slot_count number of slots
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_combine, \p p_data_buffer or \p p_slots is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR as for circularBuffer_init, or if \p slot_count is 0
+ * @retval CIRC_BUF_IO_ERROR if the lock could not be initialized
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCombine_init(circularBufferCombine_t *p_combine, void *p_data_buffer, size_t data_buffer_size, size_t item_size, circularBufferCombineSlot_t *p_slots, size_t slot_count, memcpy_t fp_memcpy);
+
+/**
+ * Release the lock. No thread may be using the buffer.
+ *
+ * @param[in] p_combine buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_combine is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCombine_destroy(circularBufferCombine_t *p_combine);
+
+/**
+ * Claim a slot for the calling thread
+ *
+ * @param[in] p_combine buffer
+ * @param[out] p_slot slot index to pass to the other functions
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_combine or \p p_slot is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if every slot is taken
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCombine_attach(circularBufferCombine_t *p_combine, size_t *p_slot);
+
+/**
+ * Give up a slot
+ *
+ * @param[in] p_combine buffer
+ * @param[in] slot slot index from circularBufferCombine_attach
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_combine is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p slot is not attached
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCombine_detach(circularBufferCombine_t *p_combine, size_t slot);
+
+/**
+ * circularBuffer_push_n through the combiner
+ *
+ * @retval CIRC_BUF_SIZE_ERROR if \p slot is not attached
+ * @retval others as for circularBuffer_push_n
+ ******************************************************************************/
+int circularBufferCombine_push_n(circularBufferCombine_t *p_combine, size_t slot, const void *p_data, size_t n);
+
+/**
+ * circularBuffer_popFIFO_n through the combiner
+ *
+ * @param[out] p_popped number of items popped. May be `NULL`.
+ * @retval CIRC_BUF_SIZE_ERROR if \p slot is not attached
+ * @retval others as for circularBuffer_popFIFO_n
+ ******************************************************************************/
+int circularBufferCombine_popFIFO_n(circularBufferCombine_t *p_combine, size_t slot, void *p_data, size_t n, size_t *p_popped);
+
+/**
+ * Get the number of items, taking the lock
+ *
+ * @param[in] p_combine buffer
+ * @param[out] result number of items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_combine or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCombine_getCount(circularBufferCombine_t *p_combine, size_t *result);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
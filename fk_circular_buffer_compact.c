@@ -0,0 +1,174 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_compact.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffers with small headers and inline storage
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include "fk_circular_buffer_compact.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+
+/* Rebuild the buffer described by header p_compact as `buffer`; the items follow the header */
+#define COMPACT_TO_CORE() \
+	circularBuffer_t buffer; \
+	VERIFY_ADDR(p_compact); \
+	compact_to_core(&buffer, (uint8_t *)(p_compact + 1), p_compact->data_size, p_compact->buffer_slots, p_compact->start, p_compact->count)
+
+/*
+ * Define circularBufferCompact<bits>_*. Every function but init rebuilds a
+ * circularBuffer_t with COMPACT_TO_CORE and calls the core function of the
+ * same name; those that can move the indices write start and count back with
+ * compact<bits>_from_core.
+ */
+#define COMPACT_DEFINE(bits) \
+static int compact##bits##_from_core(circularBufferCompact##bits##_t *p_compact, const circularBuffer_t *p_buffer, int ret) \
+{ \
+	p_compact->start = (uint##bits##_t)p_buffer->start; \
+	p_compact->count = (uint##bits##_t)p_buffer->count; \
+	return ret; \
+} \
+\
+int circularBufferCompact##bits##_init(circularBufferCompact##bits##_t *p_region, size_t region_size, size_t item_size) \
+{ \
+	size_t slots; \
+\
+	VERIFY_ADDR(p_region); \
+	VERIFY_SIZE(item_size); \
+\
+	if (region_size < sizeof(*p_region)) { \
+		return CIRC_BUF_SIZE_ERROR; \
+	} \
+	slots = (region_size - sizeof(*p_region)) / item_size; \
+	if (0 == slots || slots > UINT##bits##_MAX || item_size > UINT##bits##_MAX) { \
+		return CIRC_BUF_SIZE_ERROR; \
+	} \
+\
+	p_region->data_size = (uint##bits##_t)item_size; \
+	p_region->buffer_slots = (uint##bits##_t)slots; \
+	p_region->start = 0; \
+	p_region->count = 0; \
+\
+	return CIRC_BUF_NO_ERROR; \
+} \
+\
+int circularBufferCompact##bits##_flush(circularBufferCompact##bits##_t *p_compact) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_flush(&buffer)); \
+} \
+\
+int circularBufferCompact##bits##_getCount(const circularBufferCompact##bits##_t *p_compact, size_t *result) \
+{ \
+	COMPACT_TO_CORE(); \
+	return circularBuffer_getCount(&buffer, result); \
+} \
+\
+int circularBufferCompact##bits##_push(circularBufferCompact##bits##_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_push(&buffer, p_data, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_push_n(circularBufferCompact##bits##_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_push_n(&buffer, p_data, n, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_peek(const circularBufferCompact##bits##_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return circularBuffer_peek(&buffer, p_data, n, fp_memcpy); \
+} \
+\
+int circularBufferCompact##bits##_popFIFO(circularBufferCompact##bits##_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_popFIFO(&buffer, p_data, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_popFIFO_n(circularBufferCompact##bits##_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_popFIFO_n(&buffer, p_data, n, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_popLIFO(circularBufferCompact##bits##_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_popLIFO(&buffer, p_data, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_popLIFO_n(circularBufferCompact##bits##_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_popLIFO_n(&buffer, p_data, n, fp_memcpy)); \
+} \
+\
+int circularBufferCompact##bits##_remove_records(circularBufferCompact##bits##_t *p_compact, size_t n) \
+{ \
+	COMPACT_TO_CORE(); \
+	return compact##bits##_from_core(p_compact, &buffer, circularBuffer_remove_records(&buffer, n)); \
+}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static void compact_to_core(circularBuffer_t *p_buffer, uint8_t *p_items, size_t data_size, size_t buffer_slots, size_t start, size_t count);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+COMPACT_DEFINE(16)
+
+COMPACT_DEFINE(32)
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static void compact_to_core(circularBuffer_t *p_buffer, uint8_t *p_items, size_t data_size, size_t buffer_slots, size_t start, size_t count)
+{
+	p_buffer->data_size = data_size;
+	p_buffer->buffer_slots = buffer_slots;
+	p_buffer->start = start;
+	p_buffer->count = count;
+	p_buffer->end = start + count;
+	if (p_buffer->end >= buffer_slots) {
+		p_buffer->end -= buffer_slots;
+	}
+	p_buffer->p_data_location = p_items;
+	p_buffer->p_watermark = NULL;
+	p_buffer->write_seq = 0;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
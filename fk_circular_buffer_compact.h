@@ -0,0 +1,405 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_compact.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffers with small headers and inline storage
+ * @details For programs holding very many small buffers. The header keeps
+ * the item size, slot count, start index and item count in 16-bit
+ * (circularBufferCompact16_t, 8 bytes) or 32-bit (circularBufferCompact32_t,
+ * 16 bytes) fields; the end index is derived, and the items follow the header
+ * in the same region. Each operation rebuilds a circularBuffer_t on the stack
+ * and calls the matching core function, so behaviour and return codes are
+ * those of the core.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_COMPACT_INCLUDED
+#define _CIRCULARBUFFER_COMPACT_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Region size for a circularBufferCompact16_t of \p slots items of \p item_size bytes */
+#define CIRC_BUF_COMPACT16_REGION_SIZE(item_size, slots) (sizeof(circularBufferCompact16_t) + (size_t)(item_size) * (size_t)(slots))
+/** Region size for a circularBufferCompact32_t of \p slots items of \p item_size bytes */
+#define CIRC_BUF_COMPACT32_REGION_SIZE(item_size, slots) (sizeof(circularBufferCompact32_t) + (size_t)(item_size) * (size_t)(slots))
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Header of a buffer with up to 65535 slots of up to 65535 bytes */
+typedef struct circularBufferCompact16{
+	uint16_t data_size;  /**< Size of an individual element */
+	uint16_t buffer_slots; /**< Number of slots */
+	uint16_t start; /**< Start index */
+	uint16_t count; /**< Elements in use */
+} circularBufferCompact16_t;
+
+/** Header of a buffer with up to 2^32 - 1 slots of up to 2^32 - 1 bytes */
+typedef struct circularBufferCompact32{
+	uint32_t data_size;  /**< Size of an individual element */
+	uint32_t buffer_slots; /**< Number of slots */
+	uint32_t start; /**< Start index */
+	uint32_t count; /**< Elements in use */
+} circularBufferCompact32_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Lay out an empty buffer at the start of \p p_region, using every slot that
+ * fits after the header. Items start `sizeof(circularBufferCompact16_t)`
+ * bytes into the region.
+ *
+ * @param[in] p_region region holding the header and the items
+ * @param[in] region_size size of \p p_region in bytes
+ * @param[in] item_size item size
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_region is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p item_size is 0, no slot fits, or the item
+ 	size or slot count does not fit in 16 bits
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact16_init(circularBufferCompact16_t *p_region, size_t region_size, size_t item_size);
+
+/**
+ * Flush (empty) a compact buffer
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact16_flush(circularBufferCompact16_t *p_compact);
+
+/**
+ * Get number of items in a compact buffer
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] result number of items in \p p_compact
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_getCount(const circularBufferCompact16_t *p_compact, size_t *result);
+
+/**
+ * Push 1 item from \p p_data onto the end of \p p_compact
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_compact->data_size bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_compact is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_push(circularBufferCompact16_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Push \p n items from \p p_data onto the end of \p p_compact
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_compact->data_size * \p n bytes in length. Must not overlap with
+ 	the region of \p p_compact.
+ * @param[in] n number of items to push
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n exceeds \p p_compact->buffer_slots
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_compact cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_push_n(circularBufferCompact16_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_compact into \p p_data without removing
+ * them
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to copy
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the item count
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_peek(const circularBufferCompact16_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the oldest item of \p p_compact into \p p_data and remove it
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size bytes in length. Must not overlap with the region of
+ 	\p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_popFIFO(circularBufferCompact16_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_compact into \p p_data and remove them.
+ * If \p n exceeds the item count, all items are popped.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_popFIFO_n(circularBufferCompact16_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the newest item of \p p_compact into \p p_data and remove it
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size bytes in length. Must not overlap with the region of
+ 	\p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_popLIFO(circularBufferCompact16_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n newest items of \p p_compact into \p p_data and remove them.
+ * If \p n exceeds the item count, all items are popped.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact16_popLIFO_n(circularBufferCompact16_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Remove the \p n oldest items from \p p_compact. If \p n exceeds the item
+ * count, all items are removed.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact16_remove_records(circularBufferCompact16_t *p_compact, size_t n);
+
+/**
+ * Lay out an empty buffer at the start of \p p_region, using every slot that
+ * fits after the header. Items start `sizeof(circularBufferCompact32_t)`
+ * bytes into the region.
+ *
+ * @param[in] p_region region holding the header and the items
+ * @param[in] region_size size of \p p_region in bytes
+ * @param[in] item_size item size
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_region is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p item_size is 0, no slot fits, or the item
+ 	size or slot count does not fit in 32 bits
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact32_init(circularBufferCompact32_t *p_region, size_t region_size, size_t item_size);
+
+/**
+ * Flush (empty) a compact buffer
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact32_flush(circularBufferCompact32_t *p_compact);
+
+/**
+ * Get number of items in a compact buffer
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] result number of items in \p p_compact
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_getCount(const circularBufferCompact32_t *p_compact, size_t *result);
+
+/**
+ * Push 1 item from \p p_data onto the end of \p p_compact
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_compact->data_size bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_compact is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_push(circularBufferCompact32_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Push \p n items from \p p_data onto the end of \p p_compact
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_compact->data_size * \p n bytes in length. Must not overlap with
+ 	the region of \p p_compact.
+ * @param[in] n number of items to push
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n exceeds \p p_compact->buffer_slots
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_compact cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_push_n(circularBufferCompact32_t *p_compact, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_compact into \p p_data without removing
+ * them
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to copy
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the item count
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_peek(const circularBufferCompact32_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the oldest item of \p p_compact into \p p_data and remove it
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size bytes in length. Must not overlap with the region of
+ 	\p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_popFIFO(circularBufferCompact32_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_compact into \p p_data and remove them.
+ * If \p n exceeds the item count, all items are popped.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_popFIFO_n(circularBufferCompact32_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the newest item of \p p_compact into \p p_data and remove it
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size bytes in length. Must not overlap with the region of
+ 	\p p_compact.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_popLIFO(circularBufferCompact32_t *p_compact, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n newest items of \p p_compact into \p p_data and remove them.
+ * If \p n exceeds the item count, all items are popped.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_compact->data_size * \p n bytes in length. Must not overlap with the
+ 	region of \p p_compact.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferCompact32_popLIFO_n(circularBufferCompact32_t *p_compact, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Remove the \p n oldest items from \p p_compact. If \p n exceeds the item
+ * count, all items are removed.
+ *
+ * @param[in] p_compact pointer to the buffer header
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_compact is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_compact is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferCompact32_remove_records(circularBufferCompact32_t *p_compact, size_t n);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
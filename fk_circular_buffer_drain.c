@@ -0,0 +1,572 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_drain.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Asynchronous drain bookkeeping for circular buffers
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef FK_CB_DRAIN_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#include "fk_circular_buffer_drain.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static int drain_sync_init(circularBufferDrainWriter_t *p_writer);
+static void drain_sync_destroy(circularBufferDrainWriter_t *p_writer);
+static void drain_release(circularBufferDrainWriter_t *p_writer);
+static void drain_prepare(circularBufferDrainWriter_t *p_writer, const circularBufferDrainBatch_t *p_batch, circularBufferDrainWrite_t *p_write);
+static void drain_advance(circularBufferDrainWrite_t *p_write, size_t bytes);
+static int drain_write_all(int fd, circularBufferDrainWrite_t *p_write);
+static void *drain_pwritev_worker(void *p_arg);
+#ifdef FK_CB_DRAIN_IO_URING
+static int drain_ring_init(circularBufferDrainRing_t *p_ring, uint32_t entries);
+static void drain_ring_exit(circularBufferDrainRing_t *p_ring);
+static void drain_ring_queue(circularBufferDrainRing_t *p_ring, int fd, const circularBufferDrainWrite_t *p_write);
+static int drain_ring_enter(circularBufferDrainRing_t *p_ring, uint32_t submit, uint32_t *p_submitted);
+static void *drain_uring_worker(void *p_arg);
+#endif
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferDrain_init(circularBufferDrain_t *p_drain, circularBuffer_t *p_buffer, circularBufferDrainRecord_t *p_records, size_t max_batches)
+{
+	VERIFY_ADDR(p_drain);
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_records);
+	VERIFY_SIZE(max_batches);
+
+	p_drain->p_buffer = p_buffer;
+	p_drain->p_records = p_records;
+	p_drain->max_batches = max_batches;
+	p_drain->oldest = 0;
+	p_drain->in_flight = 0;
+	p_drain->submitted = 0;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferDrain_next(circularBufferDrain_t *p_drain, size_t max_items, circularBufferDrainBatch_t *p_batch)
+{
+	circularBufferDrainRecord_t *p_record;
+	int ret;
+
+	VERIFY_ADDR(p_drain);
+	VERIFY_ADDR(p_batch);
+	VERIFY_SIZE(max_items);
+
+	if (p_drain->in_flight == p_drain->max_batches) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+
+	ret = circularBuffer_peek_spans(p_drain->p_buffer, p_drain->submitted, max_items, p_batch->spans, &p_batch->span_count);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	p_batch->items = (p_batch->spans[0].size + p_batch->spans[1].size) / p_drain->p_buffer->data_size;
+	p_batch->id = p_drain->oldest + p_drain->in_flight;
+
+	p_record = &p_drain->p_records[p_batch->id % p_drain->max_batches];
+	p_record->items = p_batch->items;
+	p_record->done = false;
+
+	p_drain->in_flight++;
+	p_drain->submitted += p_batch->items;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferDrain_complete(circularBufferDrain_t *p_drain, size_t id)
+{
+	circularBufferDrainRecord_t *p_record;
+
+	VERIFY_ADDR(p_drain);
+
+	if (id - p_drain->oldest >= p_drain->in_flight) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	p_drain->p_records[id % p_drain->max_batches].done = true;
+
+	/* retire completed batches in submission order */
+	while (p_drain->in_flight > 0) {
+		p_record = &p_drain->p_records[p_drain->oldest % p_drain->max_batches];
+		if (!p_record->done) {
+			break;
+		}
+		circularBuffer_remove_records(p_drain->p_buffer, p_record->items);
+		p_drain->submitted -= p_record->items;
+		p_drain->oldest++;
+		p_drain->in_flight--;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferDrain_in_flight(const circularBufferDrain_t *p_drain, size_t *result)
+{
+	VERIFY_ADDR(p_drain);
+	VERIFY_ADDR(result);
+
+	*result = p_drain->in_flight;
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferDrainWriter_start(circularBufferDrainWriter_t *p_writer, circularBufferDrain_t *p_drain, circularBufferDrainBackend_t backend, int fd, off_t offset, size_t batch_items)
+{
+	void *(*fp_worker)(void *);
+
+	VERIFY_ADDR(p_writer);
+	VERIFY_ADDR(p_drain);
+	VERIFY_SIZE(batch_items);
+
+	switch (backend) {
+	case CIRC_BUF_DRAIN_PWRITEV:
+		fp_worker = drain_pwritev_worker;
+		break;
+#ifdef FK_CB_DRAIN_IO_URING
+	case CIRC_BUF_DRAIN_IO_URING:
+		if (p_drain->max_batches > CIRC_BUF_DRAIN_URING_DEPTH) {
+			return CIRC_BUF_SIZE_ERROR;
+		}
+		fp_worker = drain_uring_worker;
+		break;
+#endif
+	default:
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+
+	p_writer->p_drain = p_drain;
+	p_writer->backend = backend;
+	p_writer->fd = fd;
+	p_writer->offset = offset;
+	p_writer->batch_items = batch_items;
+	p_writer->stop = false;
+	p_writer->running = true;
+	p_writer->error = CIRC_BUF_NO_ERROR;
+
+	if (drain_sync_init(p_writer) != CIRC_BUF_NO_ERROR) {
+		return CIRC_BUF_IO_ERROR;
+	}
+#ifdef FK_CB_DRAIN_IO_URING
+	if (CIRC_BUF_DRAIN_IO_URING == backend && drain_ring_init(&p_writer->ring, (uint32_t)p_drain->max_batches) != CIRC_BUF_NO_ERROR) {
+		drain_sync_destroy(p_writer);
+		return CIRC_BUF_IO_ERROR;
+	}
+#endif
+	if (pthread_create(&p_writer->thread, NULL, fp_worker, p_writer) != 0) {
+		drain_release(p_writer);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferDrainWriter_push(circularBufferDrainWriter_t *p_writer, const void *p_data, size_t n)
+{
+	int ret;
+
+	VERIFY_ADDR(p_writer);
+	VERIFY_ADDR(p_data);
+
+	pthread_mutex_lock(&p_writer->lock);
+	if (p_writer->error != CIRC_BUF_NO_ERROR) {
+		ret = CIRC_BUF_IO_ERROR;
+	} else {
+		ret = circularBuffer_push_n(p_writer->p_drain->p_buffer, p_data, n, NULL);
+		if (CIRC_BUF_NO_ERROR == ret) {
+			pthread_cond_signal(&p_writer->wake);
+		}
+	}
+	pthread_mutex_unlock(&p_writer->lock);
+
+	return ret;
+}
+
+int circularBufferDrainWriter_flush(circularBufferDrainWriter_t *p_writer)
+{
+	int ret;
+
+	VERIFY_ADDR(p_writer);
+
+	pthread_mutex_lock(&p_writer->lock);
+	while (p_writer->running && CIRC_BUF_NO_ERROR == p_writer->error && p_writer->p_drain->p_buffer->count > 0) {
+		pthread_cond_wait(&p_writer->idle, &p_writer->lock);
+	}
+	ret = p_writer->error;
+	pthread_mutex_unlock(&p_writer->lock);
+
+	return ret;
+}
+
+int circularBufferDrainWriter_stop(circularBufferDrainWriter_t *p_writer)
+{
+	VERIFY_ADDR(p_writer);
+
+	pthread_mutex_lock(&p_writer->lock);
+	p_writer->stop = true;
+	pthread_cond_signal(&p_writer->wake);
+	pthread_mutex_unlock(&p_writer->lock);
+	pthread_join(p_writer->thread, NULL);
+
+	drain_release(p_writer);
+
+	return p_writer->error;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static int drain_sync_init(circularBufferDrainWriter_t *p_writer)
+{
+	if (pthread_mutex_init(&p_writer->lock, NULL) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (pthread_cond_init(&p_writer->wake, NULL) != 0) {
+		pthread_mutex_destroy(&p_writer->lock);
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (pthread_cond_init(&p_writer->idle, NULL) != 0) {
+		pthread_cond_destroy(&p_writer->wake);
+		pthread_mutex_destroy(&p_writer->lock);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+static void drain_sync_destroy(circularBufferDrainWriter_t *p_writer)
+{
+	pthread_cond_destroy(&p_writer->idle);
+	pthread_cond_destroy(&p_writer->wake);
+	pthread_mutex_destroy(&p_writer->lock);
+}
+
+static void drain_release(circularBufferDrainWriter_t *p_writer)
+{
+#ifdef FK_CB_DRAIN_IO_URING
+	if (CIRC_BUF_DRAIN_IO_URING == p_writer->backend) {
+		drain_ring_exit(&p_writer->ring);
+	}
+#endif
+	drain_sync_destroy(p_writer);
+}
+
+/* Called with the writer locked; batches get consecutive file offsets */
+static void drain_prepare(circularBufferDrainWriter_t *p_writer, const circularBufferDrainBatch_t *p_batch, circularBufferDrainWrite_t *p_write)
+{
+	size_t i;
+
+	p_write->id = p_batch->id;
+	p_write->iov_count = (int)p_batch->span_count;
+	p_write->offset = p_writer->offset;
+	for (i = 0; i < p_batch->span_count; i++) {
+		p_write->iov[i].iov_base = p_batch->spans[i].p_data;
+		p_write->iov[i].iov_len = p_batch->spans[i].size;
+		p_writer->offset += (off_t)p_batch->spans[i].size;
+	}
+}
+
+static void drain_advance(circularBufferDrainWrite_t *p_write, size_t bytes)
+{
+	p_write->offset += (off_t)bytes;
+	while (bytes > 0 && p_write->iov_count > 0) {
+		if (bytes < p_write->iov[0].iov_len) {
+			p_write->iov[0].iov_base = (uint8_t *)p_write->iov[0].iov_base + bytes;
+			p_write->iov[0].iov_len -= bytes;
+			bytes = 0;
+		} else {
+			bytes -= p_write->iov[0].iov_len;
+			p_write->iov[0] = p_write->iov[1];
+			p_write->iov_count--;
+		}
+	}
+}
+
+static int drain_write_all(int fd, circularBufferDrainWrite_t *p_write)
+{
+	ssize_t written;
+
+	while (p_write->iov_count > 0) {
+		written = pwritev(fd, p_write->iov, p_write->iov_count, p_write->offset);
+		if (written < 0 && EINTR == errno) {
+			continue;
+		}
+		if (written <= 0) {
+			return CIRC_BUF_IO_ERROR;
+		}
+		drain_advance(p_write, (size_t)written);
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+/*
+ * The items of a batch stay in the buffer until the batch completes, so the
+ * producer never writes over them and they can be read without the lock.
+ */
+static void *drain_pwritev_worker(void *p_arg)
+{
+	circularBufferDrainWriter_t *p_writer = p_arg;
+	circularBufferDrainBatch_t batch;
+	circularBufferDrainWrite_t write;
+	int ret;
+
+	pthread_mutex_lock(&p_writer->lock);
+	while (CIRC_BUF_NO_ERROR == p_writer->error) {
+		if (circularBufferDrain_next(p_writer->p_drain, p_writer->batch_items, &batch) != CIRC_BUF_NO_ERROR) {
+			if (p_writer->stop) {
+				break;
+			}
+			pthread_cond_wait(&p_writer->wake, &p_writer->lock);
+			continue;
+		}
+		drain_prepare(p_writer, &batch, &write);
+		pthread_mutex_unlock(&p_writer->lock);
+
+		ret = drain_write_all(p_writer->fd, &write);
+
+		pthread_mutex_lock(&p_writer->lock);
+		if (ret != CIRC_BUF_NO_ERROR) {
+			p_writer->error = ret;
+			break;
+		}
+		circularBufferDrain_complete(p_writer->p_drain, batch.id);
+		pthread_cond_broadcast(&p_writer->idle);
+	}
+	p_writer->running = false;
+	pthread_cond_broadcast(&p_writer->idle);
+	pthread_mutex_unlock(&p_writer->lock);
+
+	return NULL;
+}
+
+#ifdef FK_CB_DRAIN_IO_URING
+static int drain_ring_init(circularBufferDrainRing_t *p_ring, uint32_t entries)
+{
+	struct io_uring_params params;
+	uint8_t *p_sq;
+	uint8_t *p_cq;
+	long fd;
+
+	memset(&params, 0, sizeof(params));
+	fd = syscall(__NR_io_uring_setup, entries, &params);
+	if (fd < 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	p_ring->fd = (int)fd;
+
+	p_ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	p_ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (p_ring->cq_map_size > p_ring->sq_map_size) {
+			p_ring->sq_map_size = p_ring->cq_map_size;
+		}
+		p_ring->cq_map_size = p_ring->sq_map_size;
+	}
+
+	p_ring->p_sq_map = mmap(NULL, p_ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p_ring->fd, (off_t)IORING_OFF_SQ_RING);
+	if (MAP_FAILED == p_ring->p_sq_map) {
+		close(p_ring->fd);
+		return CIRC_BUF_IO_ERROR;
+	}
+	p_ring->p_cq_map = p_ring->p_sq_map;
+	if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+		p_ring->p_cq_map = mmap(NULL, p_ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p_ring->fd, (off_t)IORING_OFF_CQ_RING);
+		if (MAP_FAILED == p_ring->p_cq_map) {
+			munmap(p_ring->p_sq_map, p_ring->sq_map_size);
+			close(p_ring->fd);
+			return CIRC_BUF_IO_ERROR;
+		}
+	}
+	p_ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+	p_ring->p_sqes = mmap(NULL, p_ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, p_ring->fd, (off_t)IORING_OFF_SQES);
+	if (MAP_FAILED == p_ring->p_sqes) {
+		if (p_ring->p_cq_map != p_ring->p_sq_map) {
+			munmap(p_ring->p_cq_map, p_ring->cq_map_size);
+		}
+		munmap(p_ring->p_sq_map, p_ring->sq_map_size);
+		close(p_ring->fd);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	p_sq = p_ring->p_sq_map;
+	p_ring->p_sq_tail = (_Atomic uint32_t *)(void *)(p_sq + params.sq_off.tail);
+	p_ring->p_sq_array = (uint32_t *)(void *)(p_sq + params.sq_off.array);
+	p_ring->sq_mask = *(uint32_t *)(void *)(p_sq + params.sq_off.ring_mask);
+
+	p_cq = p_ring->p_cq_map;
+	p_ring->p_cq_head = (_Atomic uint32_t *)(void *)(p_cq + params.cq_off.head);
+	p_ring->p_cq_tail = (_Atomic uint32_t *)(void *)(p_cq + params.cq_off.tail);
+	p_ring->cq_mask = *(uint32_t *)(void *)(p_cq + params.cq_off.ring_mask);
+	p_ring->p_cqes = (struct io_uring_cqe *)(void *)(p_cq + params.cq_off.cqes);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+static void drain_ring_exit(circularBufferDrainRing_t *p_ring)
+{
+	munmap(p_ring->p_sqes, p_ring->sqes_size);
+	if (p_ring->p_cq_map != p_ring->p_sq_map) {
+		munmap(p_ring->p_cq_map, p_ring->cq_map_size);
+	}
+	munmap(p_ring->p_sq_map, p_ring->sq_map_size);
+	close(p_ring->fd);
+}
+
+static void drain_ring_queue(circularBufferDrainRing_t *p_ring, int fd, const circularBufferDrainWrite_t *p_write)
+{
+	uint32_t tail = atomic_load_explicit(p_ring->p_sq_tail, memory_order_relaxed);
+	uint32_t index = tail & p_ring->sq_mask;
+	struct io_uring_sqe *p_sqe = &p_ring->p_sqes[index];
+
+	memset(p_sqe, 0, sizeof(*p_sqe));
+	p_sqe->opcode = IORING_OP_WRITEV;
+	p_sqe->fd = fd;
+	p_sqe->addr = (uint64_t)(uintptr_t)p_write->iov;
+	p_sqe->len = (uint32_t)p_write->iov_count;
+	p_sqe->off = (uint64_t)p_write->offset;
+	p_sqe->user_data = p_write->id;
+	p_ring->p_sq_array[index] = index;
+
+	/* publish the entry before the kernel can see the new tail */
+	atomic_store_explicit(p_ring->p_sq_tail, tail + 1, memory_order_release);
+}
+
+/* Submit \p submit queued entries and wait for at least one completion */
+static int drain_ring_enter(circularBufferDrainRing_t *p_ring, uint32_t submit, uint32_t *p_submitted)
+{
+	long ret;
+
+	do {
+		ret = syscall(__NR_io_uring_enter, p_ring->fd, submit, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+	} while (ret < 0 && EINTR == errno);
+	if (ret < 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	*p_submitted = (uint32_t)ret;
+	return CIRC_BUF_NO_ERROR;
+}
+
+/*
+ * Keeps every batch the bookkeeping hands out in flight at once. Completions
+ * are reaped without the lock; a short write is finished with pwritev on this
+ * thread before its batch is marked complete.
+ */
+static void *drain_uring_worker(void *p_arg)
+{
+	circularBufferDrainWriter_t *p_writer = p_arg;
+	circularBufferDrainRing_t *p_ring = &p_writer->ring;
+	circularBufferDrainBatch_t batch;
+	circularBufferDrainWrite_t *p_write;
+	size_t done[CIRC_BUF_DRAIN_URING_DEPTH];
+	size_t done_count;
+	size_t i;
+	uint32_t queued = 0;
+	uint32_t pending = 0;
+	uint32_t submitted;
+	uint32_t head;
+	int status;
+
+	pthread_mutex_lock(&p_writer->lock);
+	for (;;) {
+		while (CIRC_BUF_NO_ERROR == p_writer->error && CIRC_BUF_NO_ERROR == circularBufferDrain_next(p_writer->p_drain, p_writer->batch_items, &batch)) {
+			p_write = &p_writer->writes[batch.id % CIRC_BUF_DRAIN_URING_DEPTH];
+			drain_prepare(p_writer, &batch, p_write);
+			drain_ring_queue(p_ring, p_writer->fd, p_write);
+			queued++;
+		}
+		if (0 == queued + pending) {
+			if (p_writer->stop || p_writer->error != CIRC_BUF_NO_ERROR) {
+				break;
+			}
+			pthread_cond_wait(&p_writer->wake, &p_writer->lock);
+			continue;
+		}
+		pthread_mutex_unlock(&p_writer->lock);
+
+		status = drain_ring_enter(p_ring, queued, &submitted);
+		if (status != CIRC_BUF_NO_ERROR) {
+			/* nothing more will complete that we could wait for */
+			pthread_mutex_lock(&p_writer->lock);
+			p_writer->error = status;
+			break;
+		}
+		queued -= submitted;
+		pending += submitted;
+
+		done_count = 0;
+		head = atomic_load_explicit(p_ring->p_cq_head, memory_order_relaxed);
+		while (head != atomic_load_explicit(p_ring->p_cq_tail, memory_order_acquire)) {
+			struct io_uring_cqe *p_cqe = &p_ring->p_cqes[head & p_ring->cq_mask];
+
+			p_write = &p_writer->writes[p_cqe->user_data % CIRC_BUF_DRAIN_URING_DEPTH];
+			if (p_cqe->res < 0) {
+				status = CIRC_BUF_IO_ERROR;
+			} else {
+				drain_advance(p_write, (size_t)p_cqe->res);
+				if (drain_write_all(p_writer->fd, p_write) != CIRC_BUF_NO_ERROR) {
+					status = CIRC_BUF_IO_ERROR;
+				} else {
+					done[done_count++] = p_write->id;
+				}
+			}
+			head++;
+			pending--;
+		}
+		atomic_store_explicit(p_ring->p_cq_head, head, memory_order_release);
+
+		pthread_mutex_lock(&p_writer->lock);
+		if (status != CIRC_BUF_NO_ERROR && CIRC_BUF_NO_ERROR == p_writer->error) {
+			p_writer->error = status;
+		}
+		for (i = 0; i < done_count; i++) {
+			circularBufferDrain_complete(p_writer->p_drain, done[i]);
+		}
+		pthread_cond_broadcast(&p_writer->idle);
+	}
+	p_writer->running = false;
+	pthread_cond_broadcast(&p_writer->idle);
+	pthread_mutex_unlock(&p_writer->lock);
+
+	return NULL;
+}
+#endif
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,269 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_drain.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Asynchronous drain of circular buffers into a file descriptor
+ * @details The bookkeeping layer (circularBufferDrain_*) hands out batches of
+ * buffered items as regions of the buffer's own storage so they can be
+ * written without an intermediate copy. Several batches may be in flight;
+ * items are removed from the buffer only when every earlier batch has
+ * completed, so completions may arrive in any order. It performs no I/O and
+ * no locking; calls on the underlying buffer must be serialized by the caller.
+ * <br>
+ * The writer (circularBufferDrainWriter_*) is built on that layer. It owns a
+ * thread that writes batches to a file descriptor at consecutive offsets
+ * while the producer keeps pushing through circularBufferDrainWriter_push, so
+ * the producer never waits on the disk. Two backends are available:
+ * - CIRC_BUF_DRAIN_PWRITEV: the thread writes one batch at a time with
+ *   `pwritev`. One thread is enough: batches go to consecutive offsets of one
+ *   file, and buffered writes to one file are serialized by the kernel's
+ *   per-inode lock, so more threads would mostly wait on each other. Each
+ *   write already covers a whole batch, at most two regions, in one call.
+ * - CIRC_BUF_DRAIN_IO_URING: the thread keeps up to `max_batches` batches in
+ *   flight as io_uring writes, which pays off with `O_DIRECT` or devices that
+ *   serve parallel requests. Only compiled into the library when
+ *   `FK_CB_DRAIN_IO_URING` is defined; uses the raw system calls, so liburing
+ *   is not needed. The header, and the writer's layout, do not depend on it.
+ *
+ * The writer requires POSIX threads.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_DRAIN_INCLUDED
+#define _CIRCULARBUFFER_DRAIN_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Most batches the io_uring backend keeps in flight */
+#define CIRC_BUF_DRAIN_URING_DEPTH 16
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Batch of items handed out for writing */
+typedef struct circularBufferDrainBatch{
+	size_t id; /**< Batch identifier, passed back to circularBufferDrain_complete */
+	size_t items; /**< Number of items in the batch */
+	size_t span_count; /**< Number of regions used in \p spans (1 or 2) */
+	circularBufferSpan_t spans[2]; /**< Storage regions holding the items */
+} circularBufferDrainBatch_t;
+
+/** Record of an in-flight batch */
+typedef struct circularBufferDrainRecord{
+	size_t items; /**< Number of items in the batch */
+	bool done; /**< Whether the batch has completed */
+} circularBufferDrainRecord_t;
+
+/** Drain state for one circular buffer */
+typedef struct circularBufferDrain{
+	circularBuffer_t *p_buffer; /**< Buffer being drained */
+	circularBufferDrainRecord_t *p_records; /**< One record per in-flight batch */
+	size_t max_batches; /**< Number of entries in \p p_records */
+	size_t oldest; /**< Identifier of the oldest in-flight batch */
+	size_t in_flight; /**< Batches in flight */
+	size_t submitted; /**< Items in flight */
+} circularBufferDrain_t;
+
+/** I/O backend used by a drain writer */
+typedef enum circularBufferDrainBackend{
+	CIRC_BUF_DRAIN_PWRITEV, /**< Writer thread calls `pwritev` for each batch */
+	CIRC_BUF_DRAIN_IO_URING /**< Writer thread submits batches to an io_uring */
+} circularBufferDrainBackend_t;
+
+/** Write of one batch */
+typedef struct circularBufferDrainWrite{
+	size_t id; /**< Batch identifier */
+	struct iovec iov[2]; /**< Regions still to be written */
+	int iov_count; /**< Entries used in \p iov */
+	off_t offset; /**< File offset of \p iov[0] */
+} circularBufferDrainWrite_t;
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * Kernel-shared submission and completion rings of one io_uring. Declared
+ * whether or not `FK_CB_DRAIN_IO_URING` is defined, so the writer has the same
+ * layout in every build; only used by the CIRC_BUF_DRAIN_IO_URING backend.
+ */
+typedef struct circularBufferDrainRing{
+	int fd; /**< io_uring file descriptor */
+	void *p_sq_map; /**< Mapping of the submission ring */
+	size_t sq_map_size; /**< Size of \p p_sq_map */
+	void *p_cq_map; /**< Mapping of the completion ring; may equal \p p_sq_map */
+	size_t cq_map_size; /**< Size of \p p_cq_map */
+	struct io_uring_sqe *p_sqes; /**< Submission queue entries */
+	size_t sqes_size; /**< Size of \p p_sqes in bytes */
+	_Atomic uint32_t *p_sq_tail; /**< Submission ring tail, written by us */
+	uint32_t *p_sq_array; /**< Submission ring indices into \p p_sqes */
+	uint32_t sq_mask; /**< Submission ring index mask */
+	_Atomic uint32_t *p_cq_head; /**< Completion ring head, written by us */
+	_Atomic uint32_t *p_cq_tail; /**< Completion ring tail, written by the kernel */
+	uint32_t cq_mask; /**< Completion ring index mask */
+	struct io_uring_cqe *p_cqes; /**< Completion queue entries */
+} circularBufferDrainRing_t;
+
+/** Thread draining a circular buffer into a file descriptor */
+typedef struct circularBufferDrainWriter{
+	circularBufferDrain_t *p_drain; /**< Bookkeeping of the buffer being drained */
+	circularBufferDrainBackend_t backend; /**< I/O backend */
+	int fd; /**< Destination file descriptor */
+	off_t offset; /**< File offset of the next batch handed out */
+	size_t batch_items; /**< Most items per batch */
+	pthread_t thread; /**< Writer thread */
+	pthread_mutex_t lock; /**< Protects the buffer, \p p_drain and the fields below */
+	pthread_cond_t wake; /**< Signalled on push and on stop */
+	pthread_cond_t idle; /**< Signalled when batches retire or the writer fails */
+	bool stop; /**< Set to finish the remaining items and exit */
+	bool running; /**< Writer thread has not exited */
+	int error; /**< First error of the writer thread, or CIRC_BUF_NO_ERROR */
+	circularBufferDrainRing_t ring; /**< io_uring of the CIRC_BUF_DRAIN_IO_URING backend */
+	circularBufferDrainWrite_t writes[CIRC_BUF_DRAIN_URING_DEPTH]; /**< In-flight writes of that backend, by batch id */
+} circularBufferDrainWriter_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize drain state for \p p_buffer
+ *
+ * @param[in] p_drain pointer to the drain state to initialize
+ * @param[in] p_buffer pointer to an initialized circular buffer
+ * @param[in] p_records storage for the in-flight batch records
+ * @param[in] max_batches number of entries in \p p_records; the maximum number
+ *								of batches in flight
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_drain, \p p_buffer or \p p_records is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p max_batches is 0
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferDrain_init(circularBufferDrain_t *p_drain, circularBuffer_t *p_buffer, circularBufferDrainRecord_t *p_records, size_t max_batches);
+
+/**
+ * Hand out the next batch of up to \p max_items items that are not already in
+ * flight. The items stay in the buffer until the batch completes.
+ *
+ * @param[in] p_drain pointer to the drain state
+ * @param[in] max_items maximum number of items in the batch
+ * @param[out] p_batch the batch to write
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_drain or \p p_batch is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p max_items is 0
+ * @retval CIRC_BUF_BUFFER_EMPTY if every buffered item is already in flight
+ * @retval CIRC_BUF_BUFFER_FULL if \p max_batches batches are already in flight
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrain_next(circularBufferDrain_t *p_drain, size_t max_items, circularBufferDrainBatch_t *p_batch);
+
+/**
+ * Mark batch \p id as written. Items of the oldest completed batches are
+ * removed from the buffer, as with circularBuffer_remove_records.
+ *
+ * @param[in] p_drain pointer to the drain state
+ * @param[in] id identifier of a batch returned by circularBufferDrain_next
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_drain is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p id is not in flight
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrain_complete(circularBufferDrain_t *p_drain, size_t id);
+
+/**
+ * Get the number of batches in flight
+ *
+ * @param[in] p_drain pointer to the drain state
+ * @param[out] result number of batches handed out and not yet retired
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_drain or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrain_in_flight(const circularBufferDrain_t *p_drain, size_t *result);
+
+/**
+ * Start a writer thread that drains the buffer of \p p_drain into \p fd.
+ * Batches are written back to back starting at file \p offset. From now on
+ * the buffer and \p p_drain may only be used through the writer until
+ * circularBufferDrainWriter_stop returns.
+ *
+ * @param[in] p_writer pointer to the writer to start
+ * @param[in] p_drain pointer to initialized drain state with no batch in flight
+ * @param[in] backend I/O backend
+ * @param[in] fd file descriptor open for writing; must support positioned writes
+ * @param[in] offset file offset of the first item
+ * @param[in] batch_items most items written per batch
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_writer or \p p_drain is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p batch_items is 0, or if \p backend is
+ *								CIRC_BUF_DRAIN_IO_URING and `max_batches` of
+ *								\p p_drain exceeds CIRC_BUF_DRAIN_URING_DEPTH
+ * @retval CIRC_BUF_FORMAT_ERROR if \p backend is unknown or not compiled in
+ * @retval CIRC_BUF_IO_ERROR if the thread, its synchronization objects or the
+ *								io_uring cannot be created
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferDrainWriter_start(circularBufferDrainWriter_t *p_writer, circularBufferDrain_t *p_drain, circularBufferDrainBackend_t backend, int fd, off_t offset, size_t batch_items);
+
+/**
+ * Push \p n items onto the drained buffer and wake the writer. Never waits for
+ * a write to finish.
+ *
+ * @param[in] p_writer pointer to a started writer
+ * @param[in] p_data pointer to \p n items
+ * @param[in] n number of items to push
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_writer or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the slot count
+ * @retval CIRC_BUF_BUFFER_FULL if the buffer cannot accept \p n more items
+ * @retval CIRC_BUF_IO_ERROR if the writer has failed; nothing is pushed
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrainWriter_push(circularBufferDrainWriter_t *p_writer, const void *p_data, size_t n);
+
+/**
+ * Wait until every item pushed so far has been written, or the writer fails
+ *
+ * @param[in] p_writer pointer to a started writer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_writer is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if a write failed; the unwritten items stay buffered
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrainWriter_flush(circularBufferDrainWriter_t *p_writer);
+
+/**
+ * Write the remaining items, stop the writer thread and release its resources.
+ * \p fd is not closed.
+ *
+ * @param[in] p_writer pointer to a started writer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_writer is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if a write failed; the unwritten items stay buffered
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferDrainWriter_stop(circularBufferDrainWriter_t *p_writer);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,299 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_latency.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer that measures how long items stay buffered
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include <time.h>
+#include "fk_circular_buffer_latency.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+
+#define SUB_BUCKETS (1u << CIRC_BUF_LATENCY_SUB_BITS)
+
+#ifdef CLOCK_MONOTONIC_COARSE
+#define LATENCY_CLOCK_ID CLOCK_MONOTONIC_COARSE
+#else
+#define LATENCY_CLOCK_ID CLOCK_MONOTONIC
+#endif
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static unsigned int latency_msb(uint64_t value);
+static size_t latency_bucket(uint64_t value);
+static uint64_t latency_bucket_upper(size_t bucket);
+static void latency_stamp(circularBufferLatency_t *p_latency, size_t slot, size_t n);
+static void latency_record(circularBufferLatency_t *p_latency, size_t slot, size_t n);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+uint64_t circularBufferLatency_clock_coarse(void)
+{
+	struct timespec now;
+
+	clock_gettime(LATENCY_CLOCK_ID, &now);
+	return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+int circularBufferLatency_init(circularBufferLatency_t *p_latency, void *p_data_buffer, size_t data_buffer_size, size_t item_size, uint64_t *p_stamps, size_t stamps_size, circularBuffer_clock_t fp_clock)
+{
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+	VERIFY_ADDR(p_stamps);
+
+	ret = circularBuffer_init(&p_latency->buffer, p_data_buffer, data_buffer_size, item_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+	if (stamps_size / sizeof(uint64_t) < p_latency->buffer.buffer_slots) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_latency->p_stamps = p_stamps;
+	p_latency->fp_clock = fp_clock ? fp_clock : circularBufferLatency_clock_coarse;
+
+	return circularBufferLatency_reset(p_latency);
+}
+
+int circularBufferLatency_push(circularBufferLatency_t *p_latency, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	size_t slot;
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+
+	slot = p_latency->buffer.end;
+	ret = circularBuffer_push(&p_latency->buffer, p_data, fp_memcpy);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		latency_stamp(p_latency, slot, 1);
+	}
+	return ret;
+}
+
+int circularBufferLatency_push_n(circularBufferLatency_t *p_latency, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	size_t slot;
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+
+	slot = p_latency->buffer.end;
+	ret = circularBuffer_push_n(&p_latency->buffer, p_data, n, fp_memcpy);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		latency_stamp(p_latency, slot, n);
+	}
+	return ret;
+}
+
+int circularBufferLatency_popFIFO(circularBufferLatency_t *p_latency, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	size_t slot;
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+
+	slot = p_latency->buffer.start;
+	ret = circularBuffer_popFIFO(&p_latency->buffer, p_data, fp_memcpy);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		latency_record(p_latency, slot, 1);
+	}
+	return ret;
+}
+
+int circularBufferLatency_popFIFO_n(circularBufferLatency_t *p_latency, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	size_t slot;
+	size_t count;
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+
+	slot = p_latency->buffer.start;
+	count = p_latency->buffer.count;
+	ret = circularBuffer_popFIFO_n(&p_latency->buffer, p_data, n, fp_memcpy);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		latency_record(p_latency, slot, count - p_latency->buffer.count);
+	}
+	return ret;
+}
+
+int circularBufferLatency_remove_records(circularBufferLatency_t *p_latency, size_t n)
+{
+	size_t slot;
+	size_t count;
+	int ret;
+
+	VERIFY_ADDR(p_latency);
+
+	slot = p_latency->buffer.start;
+	count = p_latency->buffer.count;
+	ret = circularBuffer_remove_records(&p_latency->buffer, n);
+	if (CIRC_BUF_NO_ERROR == ret) {
+		latency_record(p_latency, slot, count - p_latency->buffer.count);
+	}
+	return ret;
+}
+
+int circularBufferLatency_quantile(const circularBufferLatency_t *p_latency, double quantile, uint64_t *result)
+{
+	uint64_t rank;
+	uint64_t seen = 0;
+	size_t i;
+
+	VERIFY_ADDR(p_latency);
+	VERIFY_ADDR(result);
+
+	if (!(quantile >= 0 && quantile <= 1)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (0 == p_latency->samples) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	/* 1-based rank of the sample at the quantile */
+	rank = (uint64_t)(quantile * (double)p_latency->samples);
+	if (rank < 1) {
+		rank = 1;
+	} else if ((double)rank < quantile * (double)p_latency->samples && rank < p_latency->samples) {
+		rank++;
+	}
+
+	for (i = 0; i < CIRC_BUF_LATENCY_BUCKETS; i++) {
+		seen += p_latency->buckets[i];
+		if (seen >= rank) {
+			break;
+		}
+	}
+
+	*result = latency_bucket_upper(i);
+	if (*result > p_latency->max) {
+		*result = p_latency->max;
+	}
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferLatency_reset(circularBufferLatency_t *p_latency)
+{
+	VERIFY_ADDR(p_latency);
+
+	p_latency->samples = 0;
+	p_latency->max = 0;
+	memset(p_latency->buckets, 0, sizeof(p_latency->buckets));
+
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static unsigned int latency_msb(uint64_t value)
+{
+#if defined(__GNUC__)
+	return 63u - (unsigned int)__builtin_clzll(value);
+#else
+	unsigned int msb = 0;
+	while (value >>= 1) {
+		msb++;
+	}
+	return msb;
+#endif
+}
+
+/*
+ * Values below SUB_BUCKETS get a bucket each. Above that, every power of two
+ * is split into SUB_BUCKETS linear buckets keyed on the bits below the msb.
+ */
+static size_t latency_bucket(uint64_t value)
+{
+	unsigned int shift;
+
+	if (value < SUB_BUCKETS) {
+		return (size_t)value;
+	}
+	shift = latency_msb(value) - CIRC_BUF_LATENCY_SUB_BITS;
+	return ((size_t)(shift + 1) << CIRC_BUF_LATENCY_SUB_BITS) + (size_t)((value >> shift) - SUB_BUCKETS);
+}
+
+static uint64_t latency_bucket_upper(size_t bucket)
+{
+	unsigned int shift;
+	uint64_t mantissa;
+
+	if (bucket < SUB_BUCKETS) {
+		return bucket;
+	}
+	shift = (unsigned int)(bucket >> CIRC_BUF_LATENCY_SUB_BITS) - 1;
+	mantissa = (bucket & (SUB_BUCKETS - 1)) + SUB_BUCKETS;
+	/* wraps to UINT64_MAX for the last bucket */
+	return ((mantissa + 1) << shift) - 1;
+}
+
+static void latency_stamp(circularBufferLatency_t *p_latency, size_t slot, size_t n)
+{
+	uint64_t now = p_latency->fp_clock();
+
+	while (n--) {
+		p_latency->p_stamps[slot] = now;
+		slot++;
+		if (slot >= p_latency->buffer.buffer_slots) {
+			slot = 0;
+		}
+	}
+}
+
+static void latency_record(circularBufferLatency_t *p_latency, size_t slot, size_t n)
+{
+	uint64_t now = p_latency->fp_clock();
+	uint64_t dwell;
+
+	while (n--) {
+		dwell = now - p_latency->p_stamps[slot];
+		p_latency->buckets[latency_bucket(dwell)]++;
+		if (dwell > p_latency->max) {
+			p_latency->max = dwell;
+		}
+		p_latency->samples++;
+		slot++;
+		if (slot >= p_latency->buffer.buffer_slots) {
+			slot = 0;
+		}
+	}
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_latency.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer that measures how long items stay buffered
+ * @details Every pushed item is stamped in a caller-supplied array that runs
+ * parallel to the buffer's slots. When the item leaves the buffer its dwell
+ * time is added to a log-linear histogram: exact below 16 ticks and within
+ * 1/16 (6.25%) of the true value above that, over the full 64-bit range.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_LATENCY_INCLUDED
+#define _CIRCULARBUFFER_LATENCY_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** log2 of the number of linear sub-buckets per power of two */
+#define CIRC_BUF_LATENCY_SUB_BITS 4
+/** Number of histogram buckets */
+#define CIRC_BUF_LATENCY_BUCKETS ((64 - CIRC_BUF_LATENCY_SUB_BITS + 1) << CIRC_BUF_LATENCY_SUB_BITS)
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** pointer to a function returning a monotonic timestamp in arbitrary ticks */
+typedef uint64_t (* circularBuffer_clock_t)(void);
+
+/** Circular buffer with dwell-time histogram */
+typedef struct circularBufferLatency{
+	circularBuffer_t buffer; /**< Underlying buffer */
+	uint64_t *p_stamps; /**< Push timestamp of each slot */
+	circularBuffer_clock_t fp_clock; /**< Timestamp source */
+	uint64_t samples; /**< Dwell times recorded */
+	uint64_t max; /**< Largest dwell time recorded */
+	uint64_t buckets[CIRC_BUF_LATENCY_BUCKETS]; /**< Dwell time histogram */
+} circularBufferLatency_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Default clock: `CLOCK_MONOTONIC_COARSE` in nanoseconds where available,
+ * otherwise `CLOCK_MONOTONIC`. Pass a TSC reader to circularBufferLatency_init
+ * for finer resolution.
+ *
+ * @return current time in nanoseconds
+ ******************************************************************************/
+uint64_t circularBufferLatency_clock_coarse(void);
+
+/**
+ * Initialize a latency-tracking buffer
+ *
+ * @param[in] p_latency pointer to the buffer to initialize
+ * @param[in] p_data_buffer pointer to the storage for the items
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size. \p data_buffer_size must be evenly divisible by
+ *								\p item_size
+ * @param[in] p_stamps pointer to one `uint64_t` per slot
+ * @param[in] stamps_size size of \p p_stamps in bytes
+ * @param[in] fp_clock timestamp source. If `NULL` is passed,
+ *								circularBufferLatency_clock_coarse will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency or \p p_stamps is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR as for circularBuffer_init, or if \p stamps_size
+ *								is too small
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferLatency_init(circularBufferLatency_t *p_latency, void *p_data_buffer, size_t data_buffer_size, size_t item_size, uint64_t *p_stamps, size_t stamps_size, circularBuffer_clock_t fp_clock);
+
+/**
+ * Push 1 item from \p p_data onto the end of \p p_latency and stamp it with
+ * the current time
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_latency->buffer.data_size bytes in length. Must not overlap
+ 	with the buffer's storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_latency is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_push(circularBufferLatency_t *p_latency, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Push \p n items from \p p_data onto the end of \p p_latency and stamp them
+ * all with the current time
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_latency->buffer.data_size * \p n bytes in length. Must not
+ 	overlap with the buffer's storage.
+ * @param[in] n number of items to push
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n exceeds the number of slots
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_latency cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_push_n(circularBufferLatency_t *p_latency, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the oldest item of \p p_latency into \p p_data, remove it and record
+ * how long it was buffered
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_latency->buffer.data_size bytes in length. Must not overlap with the
+ 	buffer's storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_latency is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_popFIFO(circularBufferLatency_t *p_latency, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_latency into \p p_data, remove them and
+ * record how long each was buffered. If \p n exceeds the item count, all
+ * items are popped.
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_latency->buffer.data_size * \p n bytes in length. Must not overlap
+ 	with the buffer's storage.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_latency is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_popFIFO_n(circularBufferLatency_t *p_latency, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Remove the \p n oldest items from \p p_latency and record how long each was
+ * buffered. If \p n exceeds the item count, all items are removed.
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_latency is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferLatency_remove_records(circularBufferLatency_t *p_latency, size_t n);
+
+/**
+ * Get the dwell time at quantile \p quantile, e.g. 0.5, 0.99 or 0.999. The
+ * result is the upper bound of the histogram bucket holding that sample,
+ * capped at the largest recorded value.
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @param[in] quantile quantile between 0 and 1 inclusive
+ * @param[out] result dwell time in clock ticks
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency or \p result is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p quantile is outside [0, 1]
+ * @retval CIRC_BUF_BUFFER_EMPTY if no dwell time has been recorded
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_quantile(const circularBufferLatency_t *p_latency, double quantile, uint64_t *result);
+
+/**
+ * Clear the histogram. Items still in the buffer keep their stamps.
+ *
+ * @param[in] p_latency pointer to the buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_latency is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferLatency_reset(circularBufferLatency_t *p_latency);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,312 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_multicast.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Single-producer circular buffer read by many independent consumers
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_multicast.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static uint64_t mcast_slowest(const circularBufferMcast_t *p_mcast, uint64_t head);
+static int mcast_position(const circularBufferMcast_t *p_mcast, size_t consumer, uint64_t *position);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferMcast_init(circularBufferMcast_t *p_mcast, void *p_data_buffer, size_t data_buffer_size, size_t item_size, circularBufferMcastCursor_t *p_cursors, size_t cursors_size)
+{
+	size_t i;
+
+	VERIFY_ADDR(p_mcast);
+	VERIFY_ADDR(p_data_buffer);
+	VERIFY_ADDR(p_cursors);
+	VERIFY_SIZE(data_buffer_size);
+	VERIFY_SIZE(item_size);
+
+	if (data_buffer_size % item_size != 0 || cursors_size < sizeof(circularBufferMcastCursor_t)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_mcast->data_size = item_size;
+	p_mcast->buffer_slots = data_buffer_size / item_size;
+	p_mcast->p_data_location = p_data_buffer;
+	p_mcast->p_cursors = p_cursors;
+	p_mcast->max_consumers = cursors_size / sizeof(circularBufferMcastCursor_t);
+	p_mcast->gate = 0;
+	atomic_init(&p_mcast->head, 0);
+	for (i = 0; i < p_mcast->max_consumers; i++) {
+		atomic_init(&p_cursors[i].position, CIRC_BUF_MCAST_DETACHED);
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_push_n(circularBufferMcast_t *p_mcast, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	uint64_t head;
+	size_t end;
+	size_t bytes_to_copy;
+	size_t bytes_copied;
+
+	VERIFY_ADDR(p_mcast);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(n);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	if (n > p_mcast->buffer_slots) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	head = atomic_load_explicit(&p_mcast->head, memory_order_relaxed);
+	if (head - p_mcast->gate > p_mcast->buffer_slots - n) {
+		p_mcast->gate = mcast_slowest(p_mcast, head);
+		if (head - p_mcast->gate > p_mcast->buffer_slots - n) {
+			return CIRC_BUF_BUFFER_FULL;
+		}
+	}
+
+	end = (size_t)(head % p_mcast->buffer_slots);
+	bytes_to_copy = n * p_mcast->data_size;
+	if (end + n > p_mcast->buffer_slots) {
+		/* we're gonna overflow */
+		bytes_copied = (p_mcast->buffer_slots - end) * p_mcast->data_size;
+		fp_memcpy(p_mcast->p_data_location + end * p_mcast->data_size, p_data, bytes_copied);
+		fp_memcpy(p_mcast->p_data_location, (const uint8_t *)p_data + bytes_copied, bytes_to_copy - bytes_copied);
+	} else {
+		fp_memcpy(p_mcast->p_data_location + end * p_mcast->data_size, p_data, bytes_to_copy);
+	}
+
+	atomic_store_explicit(&p_mcast->head, head + n, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_attach(circularBufferMcast_t *p_mcast, size_t *consumer)
+{
+	uint64_t expected;
+	uint64_t head;
+	size_t i;
+
+	VERIFY_ADDR(p_mcast);
+	VERIFY_ADDR(consumer);
+
+	for (i = 0; i < p_mcast->max_consumers; i++) {
+		expected = CIRC_BUF_MCAST_DETACHED;
+		head = atomic_load_explicit(&p_mcast->head, memory_order_acquire);
+		if (atomic_compare_exchange_strong_explicit(&p_mcast->p_cursors[i].position, &expected, head, memory_order_seq_cst, memory_order_relaxed)) {
+			/*
+			 * The producer may have scanned the cursors before the claim above
+			 * and cached a gate newer than head. Its head store preceded that
+			 * scan, so re-reading head after the claim yields a position at
+			 * or past the gate; if instead the scan saw the claim, any later
+			 * position is safe too.
+			 */
+			atomic_thread_fence(memory_order_seq_cst);
+			head = atomic_load_explicit(&p_mcast->head, memory_order_acquire);
+			atomic_store_explicit(&p_mcast->p_cursors[i].position, head, memory_order_release);
+			*consumer = i;
+			return CIRC_BUF_NO_ERROR;
+		}
+	}
+
+	return CIRC_BUF_BUFFER_FULL;
+}
+
+int circularBufferMcast_detach(circularBufferMcast_t *p_mcast, size_t consumer)
+{
+	uint64_t position;
+	int ret;
+
+	ret = mcast_position(p_mcast, consumer, &position);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	atomic_store_explicit(&p_mcast->p_cursors[consumer].position, CIRC_BUF_MCAST_DETACHED, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_getCount(const circularBufferMcast_t *p_mcast, size_t consumer, size_t *result)
+{
+	uint64_t position;
+	int ret;
+
+	VERIFY_ADDR(result);
+
+	ret = mcast_position(p_mcast, consumer, &position);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	*result = (size_t)(atomic_load_explicit(&p_mcast->head, memory_order_acquire) - position);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_peek_spans(const circularBufferMcast_t *p_mcast, size_t consumer, size_t n, circularBufferSpan_t spans[2], size_t *span_count)
+{
+	uint64_t position;
+	uint64_t head;
+	size_t start;
+	size_t first_items;
+	int ret;
+
+	VERIFY_ADDR(spans);
+	VERIFY_SIZE(n);
+
+	ret = mcast_position(p_mcast, consumer, &position);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	head = atomic_load_explicit(&p_mcast->head, memory_order_acquire);
+	if (head == position) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > head - position) {
+		n = (size_t)(head - position);
+	}
+
+	start = (size_t)(position % p_mcast->buffer_slots);
+	first_items = p_mcast->buffer_slots - start;
+	if (first_items > n) {
+		first_items = n;
+	}
+
+	spans[0].p_data = p_mcast->p_data_location + start * p_mcast->data_size;
+	spans[0].size = first_items * p_mcast->data_size;
+	spans[1].p_data = p_mcast->p_data_location;
+	spans[1].size = (n - first_items) * p_mcast->data_size;
+	if (span_count != NULL) {
+		*span_count = spans[1].size ? 2 : 1;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_release(circularBufferMcast_t *p_mcast, size_t consumer, size_t n)
+{
+	uint64_t position;
+	uint64_t head;
+	int ret;
+
+	ret = mcast_position(p_mcast, consumer, &position);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	head = atomic_load_explicit(&p_mcast->head, memory_order_acquire);
+	if (head == position) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > head - position) {
+		n = (size_t)(head - position);
+	}
+
+	/* our reads of the released slots must finish before the producer reuses them */
+	atomic_store_explicit(&p_mcast->p_cursors[consumer].position, position + n, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferMcast_popFIFO_n(circularBufferMcast_t *p_mcast, size_t consumer, void * FK_CB_KW_RESTRICT p_data, size_t n, size_t *popped, memcpy_t fp_memcpy)
+{
+	circularBufferSpan_t spans[2];
+	int ret;
+
+	VERIFY_ADDR(p_data);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	ret = circularBufferMcast_peek_spans(p_mcast, consumer, n, spans, NULL);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	fp_memcpy(p_data, spans[0].p_data, spans[0].size);
+	if (spans[1].size) {
+		fp_memcpy((uint8_t *)p_data + spans[0].size, spans[1].p_data, spans[1].size);
+	}
+	n = (spans[0].size + spans[1].size) / p_mcast->data_size;
+	if (popped != NULL) {
+		*popped = n;
+	}
+
+	return circularBufferMcast_release(p_mcast, consumer, n);
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+/*
+ * Oldest position any attached consumer still needs; \p head if none is
+ * attached. Pairs with the fence in circularBufferMcast_attach.
+ */
+static uint64_t mcast_slowest(const circularBufferMcast_t *p_mcast, uint64_t head)
+{
+	uint64_t slowest = head;
+	uint64_t position;
+	size_t i;
+
+	atomic_thread_fence(memory_order_seq_cst);
+	for (i = 0; i < p_mcast->max_consumers; i++) {
+		position = atomic_load_explicit(&p_mcast->p_cursors[i].position, memory_order_acquire);
+		if (position != CIRC_BUF_MCAST_DETACHED && position < slowest) {
+			slowest = position;
+		}
+	}
+
+	return slowest;
+}
+
+static int mcast_position(const circularBufferMcast_t *p_mcast, size_t consumer, uint64_t *position)
+{
+	VERIFY_ADDR(p_mcast);
+
+	if (consumer >= p_mcast->max_consumers) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	*position = atomic_load_explicit(&p_mcast->p_cursors[consumer].position, memory_order_relaxed);
+	if (CIRC_BUF_MCAST_DETACHED == *position) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,196 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_multicast.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Single-producer circular buffer read by many independent consumers
+ * @details The producer writes each item once. Every attached consumer has
+ * its own read cursor, reads items in place and releases them when done; a
+ * slot is reused only after the slowest attached consumer has released it.
+ * Consumers attach and detach at any time from any thread. The producer
+ * caches the slowest cursor and rescans the cursors only when the cached
+ * value says the buffer is full.<br>
+ * Requires a C11 compiler with `<stdatomic.h>`.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_MULTICAST_INCLUDED
+#define _CIRCULARBUFFER_MULTICAST_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <stdatomic.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Cache line size assumed when separating consumer cursors */
+#define CIRC_BUF_MCAST_CACHE_LINE 64
+/** Cursor value marking an unused consumer entry */
+#define CIRC_BUF_MCAST_DETACHED UINT64_MAX
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Read position of one consumer, on its own cache line */
+typedef struct circularBufferMcastCursor{
+	_Atomic uint64_t position; /**< Items released, or `CIRC_BUF_MCAST_DETACHED` */
+	uint8_t pad[CIRC_BUF_MCAST_CACHE_LINE - sizeof(uint64_t)]; /**< Padding */
+} circularBufferMcastCursor_t;
+
+/** Multicast circular buffer */
+typedef struct circularBufferMcast{
+	size_t data_size;  /**< Size of an individual element */
+	size_t buffer_slots; /**< Number of slots */
+	uint8_t *p_data_location;  /**< data pointer */
+	circularBufferMcastCursor_t *p_cursors; /**< One entry per possible consumer */
+	size_t max_consumers; /**< Number of entries in \p p_cursors */
+	uint64_t gate; /**< Producer only: slowest cursor at the last scan */
+	_Atomic uint64_t head; /**< Items ever pushed; written by the producer */
+} circularBufferMcast_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize a multicast buffer with no consumers attached
+ *
+ * @param[in] p_mcast pointer to the buffer to initialize
+ * @param[in] p_data_buffer pointer to the storage for the items
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size. \p data_buffer_size must be evenly divisible by
+ *								\p item_size
+ * @param[in] p_cursors storage for the consumer cursors
+ * @param[in] cursors_size size of \p p_cursors in bytes; one
+ *								circularBufferMcastCursor_t per consumer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast, \p p_data_buffer or \p p_cursors is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if a size is 0, \p item_size does not evenly
+ *								divide \p data_buffer_size, or \p cursors_size
+ *								holds no cursor
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferMcast_init(circularBufferMcast_t *p_mcast, void *p_data_buffer, size_t data_buffer_size, size_t item_size, circularBufferMcastCursor_t *p_cursors, size_t cursors_size);
+
+/**
+ * Append \p n items. Producer only. Items pushed while no consumer is attached
+ * are discarded as soon as their slots are needed.
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] p_data pointer to \p n items
+ * @param[in] n number of items
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the number of slots
+ * @retval CIRC_BUF_BUFFER_FULL if the slowest consumer has not released enough
+ 	slots; nothing is pushed
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_push_n(circularBufferMcast_t *p_mcast, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Attach a new consumer. It sees only items pushed after it attaches.
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[out] consumer identifier of the new consumer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast or \p consumer is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if every cursor entry is in use
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_attach(circularBufferMcast_t *p_mcast, size_t *consumer);
+
+/**
+ * Detach a consumer. Items it has not released become reusable by the
+ * producer.
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] consumer identifier from circularBufferMcast_attach
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p consumer is not attached
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_detach(circularBufferMcast_t *p_mcast, size_t consumer);
+
+/**
+ * Get the number of items \p consumer has not yet released
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] consumer identifier from circularBufferMcast_attach
+ * @param[out] result number of items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast or \p result is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p consumer is not attached
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_getCount(const circularBufferMcast_t *p_mcast, size_t consumer, size_t *result);
+
+/**
+ * Locate up to \p n of \p consumer's oldest unreleased items in place, as
+ * circularBuffer_peek_spans does. The regions stay valid until \p consumer
+ * releases the items.
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] consumer identifier from circularBufferMcast_attach
+ * @param[in] n maximum number of items to locate
+ * @param[out] spans array of two regions; unused entries have a `size` of 0
+ * @param[out] span_count number of regions used (1 or 2). May be `NULL`.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast or \p spans is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or \p consumer is not attached
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p consumer has no unreleased items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_peek_spans(const circularBufferMcast_t *p_mcast, size_t consumer, size_t n, circularBufferSpan_t spans[2], size_t *span_count);
+
+/**
+ * Release up to \p n of \p consumer's oldest items
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] consumer identifier from circularBufferMcast_attach
+ * @param[in] n number of items to release
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p consumer is not attached
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p consumer has no unreleased items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_release(circularBufferMcast_t *p_mcast, size_t consumer, size_t n);
+
+/**
+ * Copy up to \p n of \p consumer's oldest items into \p p_data and release them
+ *
+ * @param[in] p_mcast pointer to the buffer
+ * @param[in] consumer identifier from circularBufferMcast_attach
+ * @param[out] p_data destination for \p n items
+ * @param[in] n maximum number of items to pop
+ * @param[out] popped number of items popped. May be `NULL`.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_mcast or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or \p consumer is not attached
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p consumer has no unreleased items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferMcast_popFIFO_n(circularBufferMcast_t *p_mcast, size_t consumer, void * FK_CB_KW_RESTRICT p_data, size_t n, size_t *popped, memcpy_t fp_memcpy);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
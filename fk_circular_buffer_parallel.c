@@ -0,0 +1,447 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_parallel.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Worker pool that splits large buffer copies across threads
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_parallel.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+
+/* returned by pool_take when no chunk is left to hand out */
+#define POOL_NO_CHUNK SIZE_MAX
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static void *pool_worker(void *p_arg);
+static void *pool_defer(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num);
+static bool pool_reserve(circularBufferPool_t *p_pool);
+static void pool_release(circularBufferPool_t *p_pool);
+/* called with the pool reserved */
+static void pool_submit(circularBufferPool_t *p_pool, const circularBufferSpan_t dst[2], const circularBufferSpan_t src[2], circularBuffer_t *p_buffer, size_t items, circularBufferPoolCommit_t commit);
+static size_t pool_take(circularBufferPool_t *p_pool);
+static void pool_run(circularBufferPool_t *p_pool, size_t chunk);
+static int pool_finish(circularBufferPool_t *p_pool);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferPool_init(circularBufferPool_t *p_pool, pthread_t *p_threads, size_t thread_count, size_t chunk_size, memcpy_t fp_memcpy)
+{
+	size_t started;
+
+	VERIFY_ADDR(p_pool);
+	if (thread_count != 0) {
+		VERIFY_ADDR(p_threads);
+	}
+
+	memset(p_pool, 0, sizeof(*p_pool));
+	p_pool->p_threads = p_threads;
+	p_pool->thread_count = thread_count;
+	p_pool->chunk_size = chunk_size ? chunk_size : CIRC_BUF_POOL_CHUNK_SIZE;
+	p_pool->fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+	if (pthread_mutex_init(&p_pool->lock, NULL) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (pthread_cond_init(&p_pool->work, NULL) != 0) {
+		pthread_mutex_destroy(&p_pool->lock);
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (pthread_cond_init(&p_pool->done, NULL) != 0) {
+		pthread_cond_destroy(&p_pool->work);
+		pthread_mutex_destroy(&p_pool->lock);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	for (started = 0; started < thread_count; started++) {
+		if (pthread_create(&p_threads[started], NULL, pool_worker, p_pool) != 0) {
+			p_pool->thread_count = started;
+			circularBufferPool_destroy(p_pool);
+			return CIRC_BUF_IO_ERROR;
+		}
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_destroy(circularBufferPool_t *p_pool)
+{
+	size_t i;
+
+	VERIFY_ADDR(p_pool);
+
+	circularBufferPool_wait(p_pool);
+
+	pthread_mutex_lock(&p_pool->lock);
+	p_pool->shutdown = true;
+	pthread_cond_broadcast(&p_pool->work);
+	pthread_mutex_unlock(&p_pool->lock);
+	for (i = 0; i < p_pool->thread_count; i++) {
+		pthread_join(p_pool->p_threads[i], NULL);
+	}
+
+	pthread_cond_destroy(&p_pool->done);
+	pthread_cond_destroy(&p_pool->work);
+	pthread_mutex_destroy(&p_pool->lock);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_memcpy(circularBufferPool_t *p_pool, void *dst, const void *src, size_t num)
+{
+	circularBufferSpan_t dst_spans[2] = {{NULL, 0}, {NULL, 0}};
+	circularBufferSpan_t src_spans[2] = {{NULL, 0}, {NULL, 0}};
+
+	VERIFY_ADDR(p_pool);
+	VERIFY_ADDR(dst);
+	VERIFY_ADDR(src);
+	VERIFY_SIZE(num);
+
+	if (!pool_reserve(p_pool)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	dst_spans[0].p_data = dst;
+	dst_spans[0].size = num;
+	src_spans[0].p_data = (uint8_t *)src;
+	src_spans[0].size = num;
+	pool_submit(p_pool, dst_spans, src_spans, NULL, 0, CIRC_BUF_POOL_COMMIT_NONE);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_copy(circularBufferPool_t *p_pool, circularBuffer_t *dst, const circularBuffer_t *src)
+{
+	circularBufferSpan_t dst_spans[2] = {{NULL, 0}, {NULL, 0}};
+	circularBufferSpan_t src_spans[2] = {{NULL, 0}, {NULL, 0}};
+	int ret;
+
+	VERIFY_ADDR(p_pool);
+
+	if (!pool_reserve(p_pool)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	/* let the core validate and copy the indices; the items are copied below */
+	ret = circularBuffer_copy(dst, src, pool_defer);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		pool_release(p_pool);
+		return ret;
+	}
+
+	dst_spans[0].p_data = dst->p_data_location;
+	dst_spans[0].size = src->buffer_slots * src->data_size;
+	src_spans[0].p_data = src->p_data_location;
+	src_spans[0].size = dst_spans[0].size;
+	pool_submit(p_pool, dst_spans, src_spans, NULL, 0, CIRC_BUF_POOL_COMMIT_NONE);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_push_n(circularBufferPool_t *p_pool, circularBuffer_t *p_buffer, const void *p_data, size_t n)
+{
+	circularBufferSpan_t dst[2];
+	circularBufferSpan_t src[2];
+	size_t first_items;
+
+	VERIFY_ADDR(p_pool);
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(n);
+
+	if (n > p_buffer->buffer_slots) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (p_buffer->count > p_buffer->buffer_slots - n) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+	if (!pool_reserve(p_pool)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	first_items = p_buffer->buffer_slots - p_buffer->end;
+	if (first_items > n) {
+		first_items = n;
+	}
+	dst[0].p_data = p_buffer->p_data_location + p_buffer->end * p_buffer->data_size;
+	dst[0].size = first_items * p_buffer->data_size;
+	dst[1].p_data = p_buffer->p_data_location;
+	dst[1].size = (n - first_items) * p_buffer->data_size;
+	src[0].p_data = (uint8_t *)p_data;
+	src[0].size = dst[0].size;
+	src[1].p_data = (uint8_t *)p_data + dst[0].size;
+	src[1].size = dst[1].size;
+	pool_submit(p_pool, dst, src, p_buffer, n, CIRC_BUF_POOL_COMMIT_ADD);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_peek(circularBufferPool_t *p_pool, const circularBuffer_t *p_buffer, void *p_data, size_t n)
+{
+	circularBufferSpan_t dst[2];
+	circularBufferSpan_t src[2];
+
+	VERIFY_ADDR(p_pool);
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(n);
+
+	if (0 == p_buffer->count) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > p_buffer->count) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (!pool_reserve(p_pool)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	circularBuffer_peek_spans(p_buffer, 0, n, src, NULL);
+	dst[0].p_data = p_data;
+	dst[0].size = src[0].size;
+	dst[1].p_data = (uint8_t *)p_data + src[0].size;
+	dst[1].size = src[1].size;
+	pool_submit(p_pool, dst, src, NULL, 0, CIRC_BUF_POOL_COMMIT_NONE);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_popFIFO_n(circularBufferPool_t *p_pool, circularBuffer_t *p_buffer, void *p_data, size_t n)
+{
+	circularBufferSpan_t dst[2];
+	circularBufferSpan_t src[2];
+
+	VERIFY_ADDR(p_pool);
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_data);
+
+	if (n > p_buffer->count) {
+		n = p_buffer->count;
+	}
+	if (0 == n) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (!pool_reserve(p_pool)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	circularBuffer_peek_spans(p_buffer, 0, n, src, NULL);
+	dst[0].p_data = p_data;
+	dst[0].size = src[0].size;
+	dst[1].p_data = (uint8_t *)p_data + src[0].size;
+	dst[1].size = src[1].size;
+	pool_submit(p_pool, dst, src, p_buffer, n, CIRC_BUF_POOL_COMMIT_REMOVE);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferPool_wait(circularBufferPool_t *p_pool)
+{
+	size_t chunk;
+	int ret;
+
+	VERIFY_ADDR(p_pool);
+
+	while ((chunk = pool_take(p_pool)) != POOL_NO_CHUNK) {
+		pool_run(p_pool, chunk);
+	}
+
+	pthread_mutex_lock(&p_pool->lock);
+	while (p_pool->finished < p_pool->chunks) {
+		pthread_cond_wait(&p_pool->done, &p_pool->lock);
+	}
+	ret = pool_finish(p_pool);
+	pthread_mutex_unlock(&p_pool->lock);
+
+	return ret;
+}
+
+int circularBufferPool_poll(circularBufferPool_t *p_pool)
+{
+	int ret = CIRC_BUF_RETRY_ERROR;
+
+	VERIFY_ADDR(p_pool);
+
+	pthread_mutex_lock(&p_pool->lock);
+	if (p_pool->finished == p_pool->chunks) {
+		ret = pool_finish(p_pool);
+	}
+	pthread_mutex_unlock(&p_pool->lock);
+
+	return ret;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static void *pool_worker(void *p_arg)
+{
+	circularBufferPool_t *p_pool = p_arg;
+	size_t chunk;
+
+	pthread_mutex_lock(&p_pool->lock);
+	for (;;) {
+		while (!p_pool->shutdown && p_pool->next_chunk >= p_pool->chunks) {
+			pthread_cond_wait(&p_pool->work, &p_pool->lock);
+		}
+		if (p_pool->shutdown) {
+			break;
+		}
+		chunk = p_pool->next_chunk++;
+		pthread_mutex_unlock(&p_pool->lock);
+		pool_run(p_pool, chunk);
+		pthread_mutex_lock(&p_pool->lock);
+	}
+	pthread_mutex_unlock(&p_pool->lock);
+
+	return NULL;
+}
+
+static void *pool_defer(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num)
+{
+	(void)src;
+	(void)num;
+	return dst;
+}
+
+/*
+ * Claim the idle pool for one submission. Checking and claiming under one
+ * lock keeps two submitting threads from both seeing the pool idle.
+ */
+static bool pool_reserve(circularBufferPool_t *p_pool)
+{
+	bool reserved = false;
+
+	pthread_mutex_lock(&p_pool->lock);
+	if (0 == p_pool->chunks && !p_pool->reserved) {
+		p_pool->reserved = true;
+		reserved = true;
+	}
+	pthread_mutex_unlock(&p_pool->lock);
+
+	return reserved;
+}
+
+/* give up a reservation without submitting */
+static void pool_release(circularBufferPool_t *p_pool)
+{
+	pthread_mutex_lock(&p_pool->lock);
+	p_pool->reserved = false;
+	pthread_mutex_unlock(&p_pool->lock);
+}
+
+static void pool_submit(circularBufferPool_t *p_pool, const circularBufferSpan_t dst[2], const circularBufferSpan_t src[2], circularBuffer_t *p_buffer, size_t items, circularBufferPoolCommit_t commit)
+{
+	size_t i;
+
+	pthread_mutex_lock(&p_pool->lock);
+	p_pool->chunks = 0;
+	for (i = 0; i < 2; i++) {
+		p_pool->p_dst[i] = dst[i].p_data;
+		p_pool->p_src[i] = src[i].p_data;
+		p_pool->size[i] = dst[i].size;
+		p_pool->chunks += (dst[i].size + p_pool->chunk_size - 1) / p_pool->chunk_size;
+	}
+	p_pool->next_chunk = 0;
+	p_pool->finished = 0;
+	p_pool->p_buffer = p_buffer;
+	p_pool->items = items;
+	p_pool->commit = commit;
+	p_pool->reserved = false;
+	pthread_cond_broadcast(&p_pool->work);
+	pthread_mutex_unlock(&p_pool->lock);
+}
+
+static size_t pool_take(circularBufferPool_t *p_pool)
+{
+	size_t chunk = POOL_NO_CHUNK;
+
+	pthread_mutex_lock(&p_pool->lock);
+	if (p_pool->next_chunk < p_pool->chunks) {
+		chunk = p_pool->next_chunk++;
+	}
+	pthread_mutex_unlock(&p_pool->lock);
+
+	return chunk;
+}
+
+/* copy one chunk, then count it as finished */
+static void pool_run(circularBufferPool_t *p_pool, size_t chunk)
+{
+	size_t first_chunks = (p_pool->size[0] + p_pool->chunk_size - 1) / p_pool->chunk_size;
+	size_t region = 0;
+	size_t offset;
+	size_t size;
+
+	if (chunk >= first_chunks) {
+		region = 1;
+		chunk -= first_chunks;
+	}
+	offset = chunk * p_pool->chunk_size;
+	size = p_pool->size[region] - offset;
+	if (size > p_pool->chunk_size) {
+		size = p_pool->chunk_size;
+	}
+	p_pool->fp_memcpy(p_pool->p_dst[region] + offset, p_pool->p_src[region] + offset, size);
+
+	pthread_mutex_lock(&p_pool->lock);
+	p_pool->finished++;
+	if (p_pool->finished == p_pool->chunks) {
+		pthread_cond_broadcast(&p_pool->done);
+	}
+	pthread_mutex_unlock(&p_pool->lock);
+}
+
+/* apply the completed copy's index update and go idle; called with the lock held */
+static int pool_finish(circularBufferPool_t *p_pool)
+{
+	int ret = CIRC_BUF_NO_ERROR;
+
+	if (CIRC_BUF_POOL_COMMIT_ADD == p_pool->commit) {
+		ret = circularBuffer_add_records(p_pool->p_buffer, p_pool->items);
+	} else if (CIRC_BUF_POOL_COMMIT_REMOVE == p_pool->commit) {
+		ret = circularBuffer_remove_records(p_pool->p_buffer, p_pool->items);
+	}
+
+	p_pool->chunks = 0;
+	p_pool->next_chunk = 0;
+	p_pool->finished = 0;
+	p_pool->p_buffer = NULL;
+	p_pool->commit = CIRC_BUF_POOL_COMMIT_NONE;
+
+	return ret;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
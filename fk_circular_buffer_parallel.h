@@ -0,0 +1,219 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_parallel.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Worker pool that splits large buffer copies across threads
+ * @details A pool runs one copy at a time. Each copy is split on the wrap
+ * point into at most two regions, and each region is split into
+ * `chunk_size` byte chunks that the workers take in turn. Submission returns
+ * at once; a submission made while another copy is in progress, from any
+ * thread, fails with CIRC_BUF_RETRY_ERROR and changes nothing. The caller then either blocks in circularBufferPool_wait, where it
+ * copies chunks alongside the workers, or checks circularBufferPool_poll.
+ * Any change to the buffer's indices is applied by whichever of those two
+ * functions sees the copy finish, on the caller's thread. Until then, the
+ * caller must not touch the regions being copied.<br>
+ * Requires POSIX threads.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_PARALLEL_INCLUDED
+#define _CIRCULARBUFFER_PARALLEL_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <pthread.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Default bytes copied by a worker per chunk */
+#define CIRC_BUF_POOL_CHUNK_SIZE (4u * 1024u * 1024u)
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Index update applied when a copy completes */
+typedef enum circularBufferPoolCommit{
+	CIRC_BUF_POOL_COMMIT_NONE, /**< Nothing to apply */
+	CIRC_BUF_POOL_COMMIT_ADD,  /**< circularBuffer_add_records */
+	CIRC_BUF_POOL_COMMIT_REMOVE /**< circularBuffer_remove_records */
+} circularBufferPoolCommit_t;
+
+/** Copy worker pool */
+typedef struct circularBufferPool{
+	pthread_t *p_threads; /**< Worker threads */
+	size_t thread_count; /**< Number of workers */
+	size_t chunk_size; /**< Bytes per chunk */
+	memcpy_t fp_memcpy; /**< Copy routine used for each chunk */
+	pthread_mutex_t lock; /**< Protects the fields below */
+	pthread_cond_t work; /**< Signalled when chunks are available */
+	pthread_cond_t done; /**< Signalled when the last chunk finishes */
+	uint8_t *p_dst[2]; /**< Destination of each region */
+	const uint8_t *p_src[2]; /**< Source of each region */
+	size_t size[2]; /**< Size of each region in bytes */
+	size_t next_chunk; /**< Next chunk to hand out */
+	size_t chunks; /**< Chunks in the current copy; 0 when idle */
+	size_t finished; /**< Chunks completed */
+	circularBuffer_t *p_buffer; /**< Buffer to update on completion */
+	size_t items; /**< Items to add or remove on completion */
+	circularBufferPoolCommit_t commit; /**< Update to apply on completion */
+	bool reserved; /**< A submission has claimed the idle pool */
+	bool shutdown; /**< Set to stop the workers */
+} circularBufferPool_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Start a pool
+ *
+ * @param[out] p_pool pool to initialize
+ * @param[in] p_threads storage for \p thread_count thread handles
+ * @param[in] thread_count number of workers. With 0, all copying is done by
+ 	the thread calling circularBufferPool_wait.
+ * @param[in] chunk_size bytes per chunk; 0 selects `CIRC_BUF_POOL_CHUNK_SIZE`
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool is `NULL`, or \p p_threads is `NULL`
+ 	and \p thread_count is not 0
+ * @retval CIRC_BUF_IO_ERROR if the lock or a condition variable could not be
+ 	initialized, or a thread could not be started; no thread is left running
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferPool_init(circularBufferPool_t *p_pool, pthread_t *p_threads, size_t thread_count, size_t chunk_size, memcpy_t fp_memcpy);
+
+/**
+ * Finish the current copy, if any, and stop the workers
+ *
+ * @param[in] p_pool pool
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_destroy(circularBufferPool_t *p_pool);
+
+/**
+ * Start copying \p num bytes from \p src to \p dst
+ *
+ * @param[in] p_pool pool
+ * @param[out] dst destination
+ * @param[in] src source; must not overlap \p dst
+ * @param[in] num number of bytes
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool, \p dst or \p src is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p num is zero
+ * @retval CIRC_BUF_RETRY_ERROR if a copy is already in progress
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_memcpy(circularBufferPool_t *p_pool, void *dst, const void *src, size_t num);
+
+/**
+ * Start circularBuffer_copy. The indices of \p dst are updated immediately;
+ * its items are valid once the copy completes.
+ *
+ * @param[in] p_pool pool
+ * @param[out] dst destination buffer; its storage must be at least as large as
+ 	that of \p src and must not overlap it
+ * @param[in] src source buffer
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool, \p dst or \p src is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if the storage of \p dst is smaller than that of \p src
+ * @retval CIRC_BUF_RETRY_ERROR if a copy is already in progress
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_copy(circularBufferPool_t *p_pool, circularBuffer_t *dst, const circularBuffer_t *src);
+
+/**
+ * Start circularBuffer_push_n. The items are appended when the copy completes.
+ *
+ * @param[in] p_pool pool
+ * @param[in] p_buffer buffer to push to
+ * @param[in] p_data pointer to \p n items; must stay valid until the copy
+ 	completes
+ * @param[in] n number of items to push
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool, \p p_buffer or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the slot count
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_buffer cannot accept \p n more items
+ * @retval CIRC_BUF_RETRY_ERROR if a copy is already in progress
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_push_n(circularBufferPool_t *p_pool, circularBuffer_t *p_buffer, const void *p_data, size_t n);
+
+/**
+ * Start circularBuffer_peek. \p p_data holds the items once the copy
+ * completes.
+ *
+ * @param[in] p_pool pool
+ * @param[in] p_buffer buffer to peek into
+ * @param[out] p_data destination for \p n items; must not overlap the storage
+ 	of \p p_buffer
+ * @param[in] n number of items to copy
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool, \p p_buffer or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or more than the items buffered
+ * @retval CIRC_BUF_RETRY_ERROR if a copy is already in progress
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_peek(circularBufferPool_t *p_pool, const circularBuffer_t *p_buffer, void *p_data, size_t n);
+
+/**
+ * Start circularBuffer_popFIFO_n. The items are removed when the copy completes.
+ * If \p n exceeds the number of items, all of them are popped.
+ *
+ * @param[in] p_pool pool
+ * @param[in] p_buffer buffer to pop from
+ * @param[out] p_data destination for up to \p n items; must not overlap the
+ 	storage of \p p_buffer
+ * @param[in] n most items to pop
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool, \p p_buffer or \p p_data is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty or \p n is zero
+ * @retval CIRC_BUF_RETRY_ERROR if a copy is already in progress
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferPool_popFIFO_n(circularBufferPool_t *p_pool, circularBuffer_t *p_buffer, void *p_data, size_t n);
+
+/**
+ * Help copy until the current copy completes, then apply its index update.
+ * The update runs circularBuffer_add_records or circularBuffer_remove_records
+ * with the pool's lock held, so a watermark callback on that buffer must not
+ * call any circularBufferPool_* function on this pool; it would deadlock.
+ *
+ * @param[in] p_pool pool
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool is `NULL`
+ * @retval CIRC_BUF_NO_ERROR when the copy is complete, or none was in progress
+ ******************************************************************************/
+int circularBufferPool_wait(circularBufferPool_t *p_pool);
+
+/**
+ * Check whether the current copy has completed; if so, apply its index update,
+ * with the pool's lock held as in circularBufferPool_wait
+ *
+ * @param[in] p_pool pool
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_pool is `NULL`
+ * @retval CIRC_BUF_RETRY_ERROR if the copy is still in progress
+ * @retval CIRC_BUF_NO_ERROR when the copy is complete, or none was in progress
+ ******************************************************************************/
+int circularBufferPool_poll(circularBufferPool_t *p_pool);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
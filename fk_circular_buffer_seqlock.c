@@ -0,0 +1,190 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_seqlock.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer with lock-free snapshots for observer threads
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_seqlock.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static size_t seq_write_begin(circularBufferSeq_t *p_seq);
+static int seq_write_end(circularBufferSeq_t *p_seq, size_t sequence, int ret);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferSeq_init(circularBufferSeq_t *p_seq, void *p_data_buffer, size_t data_buffer_size, size_t item_size)
+{
+	VERIFY_ADDR(p_seq);
+
+	atomic_init(&p_seq->sequence, 0);
+	atomic_init(&p_seq->start, 0);
+	atomic_init(&p_seq->count, 0);
+
+	return circularBuffer_init(&p_seq->buffer, p_data_buffer, data_buffer_size, item_size);
+}
+
+int circularBufferSeq_flush(circularBufferSeq_t *p_seq)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_flush(&p_seq->buffer));
+}
+
+int circularBufferSeq_push(circularBufferSeq_t *p_seq, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_push(&p_seq->buffer, p_data, fp_memcpy));
+}
+
+int circularBufferSeq_push_n(circularBufferSeq_t *p_seq, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_push_n(&p_seq->buffer, p_data, n, fp_memcpy));
+}
+
+int circularBufferSeq_popFIFO(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_popFIFO(&p_seq->buffer, p_data, fp_memcpy));
+}
+
+int circularBufferSeq_popFIFO_n(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_popFIFO_n(&p_seq->buffer, p_data, n, fp_memcpy));
+}
+
+int circularBufferSeq_popLIFO(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_popLIFO(&p_seq->buffer, p_data, fp_memcpy));
+}
+
+int circularBufferSeq_remove_records(circularBufferSeq_t *p_seq, size_t n)
+{
+	VERIFY_ADDR(p_seq);
+	return seq_write_end(p_seq, seq_write_begin(p_seq), circularBuffer_remove_records(&p_seq->buffer, n));
+}
+
+int circularBufferSeq_snapshot(const circularBufferSeq_t *p_seq, void *p_data, size_t n, circularBufferSeqSnapshot_t *p_snapshot, unsigned int max_attempts)
+{
+	size_t slots;
+	size_t data_size;
+	size_t before;
+	size_t start;
+	size_t count;
+	size_t first;
+	size_t first_items;
+	size_t items;
+	unsigned int attempt;
+
+	VERIFY_ADDR(p_seq);
+	VERIFY_ADDR(p_data);
+
+	/* fixed at init, so safe to read without synchronization */
+	slots = p_seq->buffer.buffer_slots;
+	data_size = p_seq->buffer.data_size;
+
+	for (attempt = 0; 0 == max_attempts || attempt < max_attempts; attempt++) {
+		before = atomic_load_explicit(&p_seq->sequence, memory_order_acquire);
+		if (before & 1) {
+			continue;
+		}
+		start = atomic_load_explicit(&p_seq->start, memory_order_relaxed);
+		count = atomic_load_explicit(&p_seq->count, memory_order_relaxed);
+		items = n > count ? count : n;
+
+		if (items > 0) {
+			first = (start + count - items) % slots;
+			first_items = slots - first;
+			if (first_items > items) {
+				first_items = items;
+			}
+			memcpy(p_data, p_seq->buffer.p_data_location + first * data_size, first_items * data_size);
+			memcpy((uint8_t *)p_data + first_items * data_size, p_seq->buffer.p_data_location, (items - first_items) * data_size);
+		}
+
+		atomic_thread_fence(memory_order_acquire);
+		if (atomic_load_explicit(&p_seq->sequence, memory_order_relaxed) != before) {
+			continue;
+		}
+
+		if (p_snapshot != NULL) {
+			p_snapshot->sequence = before;
+			p_snapshot->start = start;
+			p_snapshot->end = (start + count) % slots;
+			p_snapshot->count = count;
+			p_snapshot->items = items;
+		}
+		return CIRC_BUF_NO_ERROR;
+	}
+
+	return CIRC_BUF_RETRY_ERROR;
+}
+
+int circularBufferSeq_getCount(const circularBufferSeq_t *p_seq, size_t *result)
+{
+	VERIFY_ADDR(p_seq);
+	VERIFY_ADDR(result);
+
+	*result = atomic_load_explicit(&p_seq->count, memory_order_relaxed);
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static size_t seq_write_begin(circularBufferSeq_t *p_seq)
+{
+	size_t sequence = atomic_load_explicit(&p_seq->sequence, memory_order_relaxed);
+
+	atomic_store_explicit(&p_seq->sequence, sequence + 1, memory_order_relaxed);
+	/* keep the odd sequence ahead of the modifications that follow */
+	atomic_thread_fence(memory_order_release);
+
+	return sequence + 1;
+}
+
+static int seq_write_end(circularBufferSeq_t *p_seq, size_t sequence, int ret)
+{
+	atomic_store_explicit(&p_seq->start, p_seq->buffer.start, memory_order_relaxed);
+	atomic_store_explicit(&p_seq->count, p_seq->buffer.count, memory_order_relaxed);
+	atomic_store_explicit(&p_seq->sequence, sequence + 1, memory_order_release);
+
+	return ret;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,220 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_seqlock.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Circular buffer with lock-free snapshots for observer threads
+ * @details One owning thread modifies the buffer through the functions in
+ * this module. Any number of observer threads may take snapshots at the same
+ * time without a lock: each modification bumps a sequence counter before and
+ * after, and a snapshot is retried if the counter changed while it was being
+ * copied. The owner pays a release fence and four plain atomic stores per
+ * call; there are no read-modify-write operations on the owner's path.<br>
+ * Requires a C11 compiler with `<stdatomic.h>`.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_SEQLOCK_INCLUDED
+#define _CIRCULARBUFFER_SEQLOCK_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <stdatomic.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Circular buffer observable by other threads */
+typedef struct circularBufferSeq{
+	circularBuffer_t buffer; /**< Underlying buffer; read or written only by the owner */
+	atomic_size_t sequence; /**< Odd while the owner is modifying \p buffer */
+	atomic_size_t start; /**< Copy of \p buffer.start for observers */
+	atomic_size_t count; /**< Copy of \p buffer.count for observers */
+} circularBufferSeq_t;
+
+/** Indices that were current when a snapshot was taken */
+typedef struct circularBufferSeqSnapshot{
+	size_t sequence; /**< Sequence counter the snapshot is consistent with */
+	size_t start; /**< Start index */
+	size_t end; /**< End index */
+	size_t count; /**< Elements in use */
+	size_t items; /**< Items copied into the snapshot */
+} circularBufferSeqSnapshot_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize an observable circular buffer. Arguments are as for
+ * circularBuffer_init.
+ *
+ * @param[in] p_seq pointer to the buffer to initialize
+ * @param[in] p_data_buffer pointer to the storage
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR as for circularBuffer_init
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferSeq_init(circularBufferSeq_t *p_seq, void *p_data_buffer, size_t data_buffer_size, size_t item_size);
+
+/**
+ * Flush (empty) an observable buffer. Owner thread only.
+ *
+ * @param[in] p_seq pointer to the observable buffer to flush
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferSeq_flush(circularBufferSeq_t *p_seq);
+
+/**
+ * Push 1 item from \p p_data onto the end of \p p_seq. Owner thread only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_seq->buffer.data_size bytes in length. Must not overlap with
+ 	the buffer's storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_seq is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_push(circularBufferSeq_t *p_seq, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Push \p n items from \p p_data onto the end of \p p_seq. Owner thread only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[in] p_data pointer to the data to push onto the buffer. Must be at
+ 	least \p p_seq->buffer.data_size * \p n bytes in length. Must not overlap
+ 	with the buffer's storage.
+ * @param[in] n number of items to push
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n exceeds the number of slots
+ * @retval CIRC_BUF_BUFFER_FULL if \p p_seq cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_push_n(circularBufferSeq_t *p_seq, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the oldest item of \p p_seq into \p p_data and remove it. Owner thread
+ * only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_seq->buffer.data_size bytes in length. Must not overlap with the
+ 	buffer's storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_seq is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_popFIFO(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Copy the \p n oldest items of \p p_seq into \p p_data and remove them. If
+ * \p n exceeds the item count, all items are popped. Owner thread only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_seq->buffer.data_size * \p n bytes in length. Must not overlap with
+ 	the buffer's storage.
+ * @param[in] n number of items to pop
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_seq is empty
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_popFIFO_n(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy the newest item of \p p_seq into \p p_data and remove it. Owner thread
+ * only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[out] p_data pointer to the destination. Must be at least
+ 	\p p_seq->buffer.data_size bytes in length. Must not overlap with the
+ 	buffer's storage.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_seq is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_popLIFO(circularBufferSeq_t *p_seq, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Remove the \p n oldest items from \p p_seq. If \p n exceeds the item count,
+ * all items are removed. Owner thread only.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_seq is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferSeq_remove_records(circularBufferSeq_t *p_seq, size_t n);
+
+/**
+ * Copy the newest \p n items (or all items, if fewer are buffered) into
+ * \p p_data in FIFO order, consistent with a single point in the owner's
+ * sequence of modifications. May be called from any thread.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[out] p_data destination. Must be at least \p p_seq->buffer.data_size
+ 	* \p n bytes in length.
+ * @param[in] n maximum number of items to copy
+ * @param[out] p_snapshot indices the copy is consistent with. May be `NULL`.
+ * @param[in] max_attempts number of attempts before giving up; 0 retries until
+ 	a consistent copy is obtained
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq or \p p_data is `NULL`
+ * @retval CIRC_BUF_RETRY_ERROR if every attempt overlapped a modification
+ * @retval CIRC_BUF_NO_ERROR on success, including when the buffer is empty
+ ******************************************************************************/
+int circularBufferSeq_snapshot(const circularBufferSeq_t *p_seq, void *p_data, size_t n, circularBufferSeqSnapshot_t *p_snapshot, unsigned int max_attempts);
+
+/**
+ * Get the number of items in \p p_seq. May be called from any thread.
+ *
+ * @param[in] p_seq pointer to the observable buffer
+ * @param[out] result number of items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_seq or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferSeq_getCount(const circularBufferSeq_t *p_seq, size_t *result);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
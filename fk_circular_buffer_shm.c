@@ -0,0 +1,380 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_shm.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Single-producer/single-consumer circular buffer in shared memory
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "fk_circular_buffer_shm.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static void shm_bind(circularBufferShm_t *p_shm, void *p_region, int fd);
+static int shm_map(circularBufferShm_t *p_shm, int fd, size_t region_size);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferShm_region_size(size_t item_size, size_t slots, size_t *result)
+{
+	VERIFY_ADDR(result);
+	VERIFY_SIZE(item_size);
+	VERIFY_SIZE(slots);
+
+	if (slots > (SIZE_MAX - sizeof(circularBufferShmHeader_t)) / item_size) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	*result = sizeof(circularBufferShmHeader_t) + slots * item_size;
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_format(circularBufferShm_t *p_shm, void *p_region, size_t region_size, size_t item_size)
+{
+	circularBufferShmHeader_t *p_header = p_region;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(p_region);
+	VERIFY_SIZE(item_size);
+
+	if (region_size < sizeof(circularBufferShmHeader_t) + item_size) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	memset(p_header, 0, sizeof(*p_header));
+	p_header->data_size = item_size;
+	p_header->buffer_slots = (region_size - sizeof(circularBufferShmHeader_t)) / item_size;
+	p_header->data_offset = sizeof(circularBufferShmHeader_t);
+	p_header->region_size = region_size;
+	atomic_init(&p_header->head, 0);
+	atomic_init(&p_header->tail, 0);
+	p_header->version = CIRC_BUF_SHM_VERSION;
+	/* publish the magic last so a concurrent attach never sees a partial header */
+	atomic_thread_fence(memory_order_release);
+	p_header->magic = CIRC_BUF_SHM_MAGIC;
+
+	shm_bind(p_shm, p_region, -1);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_open_region(circularBufferShm_t *p_shm, void *p_region, size_t region_size, size_t item_size)
+{
+	const circularBufferShmHeader_t *p_header = p_region;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(p_region);
+
+	if (region_size < sizeof(circularBufferShmHeader_t)) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	if (p_header->magic != CIRC_BUF_SHM_MAGIC || p_header->version != CIRC_BUF_SHM_VERSION) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	atomic_thread_fence(memory_order_acquire);
+
+	if (p_header->data_offset != sizeof(circularBufferShmHeader_t)
+		|| p_header->region_size > region_size
+		|| 0 == p_header->data_size
+		|| 0 == p_header->buffer_slots
+		|| p_header->buffer_slots > (p_header->region_size - p_header->data_offset) / p_header->data_size) {
+		return CIRC_BUF_FORMAT_ERROR;
+	}
+	if (item_size != 0 && item_size != p_header->data_size) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	shm_bind(p_shm, p_region, -1);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_create(circularBufferShm_t *p_shm, const char *name, size_t item_size, size_t slots)
+{
+	size_t region_size;
+	int fd;
+	int ret;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(name);
+
+	ret = circularBufferShm_region_size(item_size, slots, &region_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (ftruncate(fd, (off_t)region_size) != 0 || shm_map(p_shm, fd, region_size) != 0) {
+		close(fd);
+		shm_unlink(name);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	circularBufferShm_format(p_shm, p_shm->p_header, region_size, item_size);
+	p_shm->fd = fd;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_attach(circularBufferShm_t *p_shm, const char *name, size_t item_size)
+{
+	struct stat info;
+	void *p_region;
+	int fd;
+	int ret;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(name);
+
+	fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	if (fstat(fd, &info) != 0 || info.st_size <= 0 || shm_map(p_shm, fd, (size_t)info.st_size) != 0) {
+		close(fd);
+		return CIRC_BUF_IO_ERROR;
+	}
+
+	p_region = p_shm->p_header;
+	ret = circularBufferShm_open_region(p_shm, p_region, (size_t)info.st_size, item_size);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		munmap(p_region, (size_t)info.st_size);
+		close(fd);
+		return ret;
+	}
+	p_shm->region_size = (size_t)info.st_size;
+	p_shm->fd = fd;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_detach(circularBufferShm_t *p_shm)
+{
+	VERIFY_ADDR(p_shm);
+
+	if (p_shm->fd >= 0) {
+		munmap(p_shm->p_header, p_shm->region_size);
+		close(p_shm->fd);
+	}
+	p_shm->p_header = NULL;
+	p_shm->p_data = NULL;
+	p_shm->fd = -1;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_unlink(const char *name)
+{
+	VERIFY_ADDR(name);
+
+	if (shm_unlink(name) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_getCount(const circularBufferShm_t *p_shm, size_t *result)
+{
+	uint64_t tail;
+	uint64_t head;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(result);
+
+	tail = atomic_load_explicit(&p_shm->p_header->tail, memory_order_acquire);
+	head = atomic_load_explicit(&p_shm->p_header->head, memory_order_acquire);
+	*result = (size_t)(head - tail);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_push_n(circularBufferShm_t *p_shm, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy)
+{
+	uint64_t head;
+	uint64_t tail;
+	size_t end;
+	size_t bytes_to_copy;
+	size_t bytes_copied;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(p_data);
+	VERIFY_SIZE(n);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	if (n > p_shm->buffer_slots) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	head = atomic_load_explicit(&p_shm->p_header->head, memory_order_relaxed);
+	tail = atomic_load_explicit(&p_shm->p_header->tail, memory_order_acquire);
+	if (head - tail > p_shm->buffer_slots - n) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+
+	end = (size_t)(head % p_shm->buffer_slots);
+	bytes_to_copy = n * p_shm->data_size;
+	if (end + n > p_shm->buffer_slots) {
+		/* we're gonna overflow */
+		bytes_copied = (p_shm->buffer_slots - end) * p_shm->data_size;
+		fp_memcpy(p_shm->p_data + end * p_shm->data_size, p_data, bytes_copied);
+		fp_memcpy(p_shm->p_data, (const uint8_t *)p_data + bytes_copied, bytes_to_copy - bytes_copied);
+	} else {
+		fp_memcpy(p_shm->p_data + end * p_shm->data_size, p_data, bytes_to_copy);
+	}
+
+	atomic_store_explicit(&p_shm->p_header->head, head + n, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_popFIFO_n(circularBufferShm_t *p_shm, void * FK_CB_KW_RESTRICT p_data, size_t n, size_t *popped, memcpy_t fp_memcpy)
+{
+	circularBufferSpan_t spans[2];
+	int ret;
+
+	VERIFY_ADDR(p_data);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	ret = circularBufferShm_peek_spans(p_shm, n, spans, NULL);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	fp_memcpy(p_data, spans[0].p_data, spans[0].size);
+	if (spans[1].size) {
+		fp_memcpy((uint8_t *)p_data + spans[0].size, spans[1].p_data, spans[1].size);
+	}
+	n = (spans[0].size + spans[1].size) / p_shm->data_size;
+	if (popped != NULL) {
+		*popped = n;
+	}
+
+	return circularBufferShm_remove_records(p_shm, n);
+}
+
+int circularBufferShm_peek_spans(const circularBufferShm_t *p_shm, size_t n, circularBufferSpan_t spans[2], size_t *span_count)
+{
+	uint64_t tail;
+	uint64_t head;
+	size_t start;
+	size_t first_items;
+
+	VERIFY_ADDR(p_shm);
+	VERIFY_ADDR(spans);
+	VERIFY_SIZE(n);
+
+	tail = atomic_load_explicit(&p_shm->p_header->tail, memory_order_relaxed);
+	head = atomic_load_explicit(&p_shm->p_header->head, memory_order_acquire);
+	if (head == tail) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > head - tail) {
+		n = (size_t)(head - tail);
+	}
+
+	start = (size_t)(tail % p_shm->buffer_slots);
+	first_items = p_shm->buffer_slots - start;
+	if (first_items > n) {
+		first_items = n;
+	}
+
+	spans[0].p_data = p_shm->p_data + start * p_shm->data_size;
+	spans[0].size = first_items * p_shm->data_size;
+	spans[1].p_data = p_shm->p_data;
+	spans[1].size = (n - first_items) * p_shm->data_size;
+	if (span_count != NULL) {
+		*span_count = spans[1].size ? 2 : 1;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferShm_remove_records(circularBufferShm_t *p_shm, size_t n)
+{
+	uint64_t tail;
+	uint64_t head;
+
+	VERIFY_ADDR(p_shm);
+
+	tail = atomic_load_explicit(&p_shm->p_header->tail, memory_order_relaxed);
+	head = atomic_load_explicit(&p_shm->p_header->head, memory_order_acquire);
+	if (head == tail) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+	if (n > head - tail) {
+		n = (size_t)(head - tail);
+	}
+
+	atomic_store_explicit(&p_shm->p_header->tail, tail + n, memory_order_release);
+
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static void shm_bind(circularBufferShm_t *p_shm, void *p_region, int fd)
+{
+	p_shm->p_header = p_region;
+	p_shm->data_size = (size_t)p_shm->p_header->data_size;
+	p_shm->buffer_slots = (size_t)p_shm->p_header->buffer_slots;
+	p_shm->region_size = (size_t)p_shm->p_header->region_size;
+	p_shm->p_data = (uint8_t *)p_region + p_shm->p_header->data_offset;
+	p_shm->fd = fd;
+}
+
+static int shm_map(circularBufferShm_t *p_shm, int fd, size_t region_size)
+{
+	void *p_region = mmap(NULL, region_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	if (MAP_FAILED == p_region) {
+		return -1;
+	}
+	p_shm->p_header = p_region;
+	return 0;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,263 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_shm.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Single-producer/single-consumer circular buffer in shared memory
+ * @details The header and the data live in one region and refer to each
+ * other only by offset, so the region may be mapped at a different address
+ * in every process. The read and write positions are free-running 64-bit
+ * counters updated with C11 atomics; one process may push while another
+ * pops without any further locking.<br>
+ * Requires a C11 compiler with `<stdatomic.h>`; circularBufferShm_create and
+ * circularBufferShm_attach additionally require POSIX shared memory.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_SHM_INCLUDED
+#define _CIRCULARBUFFER_SHM_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <limits.h>
+#include <stdatomic.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/*
+ * head and tail are shared between processes. A lock-based atomic would keep
+ * its lock in the address space of one process, so they must be lock-free,
+ * i.e. address-free, 64-bit atomics.
+ */
+#if ULLONG_MAX != UINT64_MAX || ATOMIC_LLONG_LOCK_FREE != 2
+#error "fk_circular_buffer_shm requires always lock-free 64-bit atomics"
+#endif
+
+/** Identifies a formatted region ("FKSH") */
+#define CIRC_BUF_SHM_MAGIC 0x48534B46u
+/** Layout version; bumped whenever circularBufferShmHeader_t changes */
+#define CIRC_BUF_SHM_VERSION 1u
+/** Cache line size assumed when separating the producer and consumer counters */
+#define CIRC_BUF_SHM_CACHE_LINE 64
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Layout of the start of a shared region. The data follows at \p data_offset. */
+typedef struct circularBufferShmHeader{
+	uint32_t magic; /**< `CIRC_BUF_SHM_MAGIC` */
+	uint32_t version; /**< `CIRC_BUF_SHM_VERSION` */
+	uint64_t data_size; /**< Size of an individual element */
+	uint64_t buffer_slots; /**< Number of slots */
+	uint64_t data_offset; /**< Offset of the first slot from the start of the region */
+	uint64_t region_size; /**< Size of the whole region in bytes */
+	uint8_t reserved[CIRC_BUF_SHM_CACHE_LINE - 40]; /**< Padding */
+	_Atomic uint64_t head; /**< Items ever pushed; written by the producer */
+	uint8_t pad_head[CIRC_BUF_SHM_CACHE_LINE - sizeof(uint64_t)]; /**< Padding */
+	_Atomic uint64_t tail; /**< Items ever popped; written by the consumer */
+	uint8_t pad_tail[CIRC_BUF_SHM_CACHE_LINE - sizeof(uint64_t)]; /**< Padding */
+} circularBufferShmHeader_t;
+
+/** Process-local handle to a shared region */
+typedef struct circularBufferShm{
+	circularBufferShmHeader_t *p_header; /**< Start of the mapped region */
+	uint8_t *p_data; /**< First slot, as mapped in this process */
+	size_t data_size; /**< Size of an individual element */
+	size_t buffer_slots; /**< Number of slots */
+	size_t region_size; /**< Size of the mapped region in bytes */
+	int fd; /**< Descriptor owned by the handle, or -1 */
+} circularBufferShm_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Compute the size of a region holding \p slots items of \p item_size bytes
+ *
+ * @param[in] item_size item size
+ * @param[in] slots number of slots
+ * @param[out] result region size in bytes
+ * @retval CIRC_BUF_ADDR_ERROR if \p result is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p item_size or \p slots is 0, or the size overflows
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_region_size(size_t item_size, size_t slots, size_t *result);
+
+/**
+ * Lay out an empty buffer in \p p_region, which the caller has already mapped
+ * (for example from `memfd_create`), and open a handle on it. Every slot that
+ * fits after the header is used.
+ *
+ * @param[out] p_shm handle to initialize
+ * @param[in] p_region start of the region; must be aligned for `uint64_t`
+ * @param[in] region_size size of \p p_region in bytes
+ * @param[in] item_size item size
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p p_region is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p item_size is 0 or no slot fits
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_format(circularBufferShm_t *p_shm, void *p_region, size_t region_size, size_t item_size);
+
+/**
+ * Open a handle on a region formatted by another process, checking its magic,
+ * version and geometry.
+ *
+ * @param[out] p_shm handle to initialize
+ * @param[in] p_region start of the region as mapped in this process
+ * @param[in] region_size size of the mapping in bytes
+ * @param[in] item_size expected item size, or 0 to accept any
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p p_region is `NULL`
+ * @retval CIRC_BUF_FORMAT_ERROR if the region is not a compatible buffer
+ * @retval CIRC_BUF_SIZE_ERROR if the item size differs from \p item_size
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_open_region(circularBufferShm_t *p_shm, void *p_region, size_t region_size, size_t item_size);
+
+/**
+ * Create the POSIX shared memory object \p name, map it and format it
+ *
+ * @param[out] p_shm handle to initialize
+ * @param[in] name shared memory object name, as for `shm_open`. Must not exist.
+ * @param[in] item_size item size
+ * @param[in] slots number of slots
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p name is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p item_size or \p slots is 0
+ * @retval CIRC_BUF_IO_ERROR if the object cannot be created or mapped
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_create(circularBufferShm_t *p_shm, const char *name, size_t item_size, size_t slots);
+
+/**
+ * Map the existing POSIX shared memory object \p name and open a handle on it
+ *
+ * @param[out] p_shm handle to initialize
+ * @param[in] name shared memory object name, as for `shm_open`
+ * @param[in] item_size expected item size, or 0 to accept any
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p name is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if the object cannot be opened or mapped
+ * @retval CIRC_BUF_FORMAT_ERROR if the object is not a compatible buffer
+ * @retval CIRC_BUF_SIZE_ERROR if the item size differs from \p item_size
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_attach(circularBufferShm_t *p_shm, const char *name, size_t item_size);
+
+/**
+ * Unmap a region mapped by circularBufferShm_create or circularBufferShm_attach.
+ * Handles opened with circularBufferShm_format or circularBufferShm_open_region
+ * are only cleared; the caller owns their mapping.
+ *
+ * @param[in] p_shm handle to close
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_detach(circularBufferShm_t *p_shm);
+
+/**
+ * Remove the POSIX shared memory object \p name. Existing mappings stay valid.
+ *
+ * @param[in] name shared memory object name
+ * @retval CIRC_BUF_ADDR_ERROR if \p name is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if the object cannot be removed
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferShm_unlink(const char *name);
+
+/**
+ * Get number of items in the shared buffer
+ *
+ * @param[in] p_shm handle
+ * @param[out] result number of items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferShm_getCount(const circularBufferShm_t *p_shm, size_t *result);
+
+/**
+ * Push \p n items from \p p_data. Producer side only.
+ *
+ * @param[in] p_shm handle
+ * @param[in] p_data pointer to \p n items
+ * @param[in] n number of items to push
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero or exceeds the slot count
+ * @retval CIRC_BUF_BUFFER_FULL if the buffer cannot accept \p n more items
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferShm_push_n(circularBufferShm_t *p_shm, const void * FK_CB_KW_RESTRICT p_data, size_t n, memcpy_t fp_memcpy);
+
+/**
+ * Copy up to \p n of the oldest items into \p p_data and remove them.
+ * Consumer side only.
+ *
+ * @param[in] p_shm handle
+ * @param[out] p_data destination for \p n items
+ * @param[in] n maximum number of items to pop
+ * @param[out] popped number of items popped. May be `NULL`.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p p_data is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferShm_popFIFO_n(circularBufferShm_t *p_shm, void * FK_CB_KW_RESTRICT p_data, size_t n, size_t *popped, memcpy_t fp_memcpy);
+
+/**
+ * Locate up to \p n of the oldest items in place, as circularBuffer_peek_spans
+ * does. Consumer side only; the regions stay valid until the items are removed
+ * with circularBufferShm_remove_records.
+ *
+ * @param[in] p_shm handle
+ * @param[in] n maximum number of items to locate
+ * @param[out] spans array of two regions; unused entries have a `size` of 0
+ * @param[out] span_count number of regions used (1 or 2). May be `NULL`.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm or \p spans is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p n is zero
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferShm_peek_spans(const circularBufferShm_t *p_shm, size_t n, circularBufferSpan_t spans[2], size_t *span_count);
+
+/**
+ * Remove up to \p n of the oldest items. Consumer side only.
+ *
+ * @param[in] p_shm handle
+ * @param[in] n number of items to remove
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_shm is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the buffer is empty
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferShm_remove_records(circularBufferShm_t *p_shm, size_t n);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,324 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_storage.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Huge-page, NUMA-placed and prefaulted storage for large buffers
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "fk_circular_buffer_storage.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+
+/* used when /proc/meminfo does not report a huge page size */
+#define STORAGE_DEFAULT_HUGE_PAGE (2u * 1024u * 1024u)
+/* MPOL_BIND from <linux/mempolicy.h>, which libc does not wrap */
+#define STORAGE_MPOL_BIND 2
+#define STORAGE_MASK_BITS (8 * sizeof(unsigned long))
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static size_t storage_huge_page_size(void);
+static size_t storage_round_up(size_t size, size_t page);
+static void *storage_map_aligned(size_t size, size_t alignment);
+static int storage_setup(circularBufferStorage_t *p_storage, size_t page, unsigned int flags);
+static int storage_bind(void *p_data, size_t size, int node);
+static void storage_prefault(void *p_data, size_t size, size_t page);
+static int storage_release(uint8_t *p_begin, uint8_t *p_end, size_t page, size_t min_bytes, int advice, size_t *p_released);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferStorage_alloc(circularBufferStorage_t *p_storage, size_t size, int node, unsigned int flags)
+{
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t huge_page = storage_huge_page_size();
+	size_t alignment;
+	void *p_map = MAP_FAILED;
+	int ret;
+
+	VERIFY_ADDR(p_storage);
+	VERIFY_SIZE(size);
+
+	if (node != CIRC_BUF_STORAGE_ANY_NODE && (node < 0 || node >= CIRC_BUF_STORAGE_MAX_NODES)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+	if (size > SIZE_MAX - 2 * huge_page) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	memset(p_storage, 0, sizeof(*p_storage));
+	p_storage->size = size;
+	p_storage->node = node;
+
+	if (flags & CIRC_BUF_STORAGE_HUGETLB) {
+		p_storage->mapped_size = storage_round_up(size, huge_page);
+		p_map = mmap(NULL, p_storage->mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (p_map != MAP_FAILED) {
+			p_storage->flags |= CIRC_BUF_STORAGE_HUGETLB;
+			p_storage->page_size = huge_page;
+		}
+	}
+
+	if (MAP_FAILED == p_map) {
+		/* transparent huge pages are only used for 2 MiB aligned ranges */
+		alignment = (flags & (CIRC_BUF_STORAGE_HUGETLB | CIRC_BUF_STORAGE_THP)) ? huge_page : page;
+		p_storage->mapped_size = storage_round_up(size, alignment);
+		p_map = storage_map_aligned(p_storage->mapped_size, alignment);
+		if (MAP_FAILED == p_map) {
+			return CIRC_BUF_IO_ERROR;
+		}
+		/* madvise splits transparent huge pages, so trim can use normal pages */
+		p_storage->page_size = page;
+		if (alignment != page && 0 == madvise(p_map, p_storage->mapped_size, MADV_HUGEPAGE)) {
+			p_storage->flags |= CIRC_BUF_STORAGE_THP;
+		}
+	}
+	p_storage->p_data = p_map;
+
+	ret = storage_setup(p_storage, page, flags);
+	if (ret != CIRC_BUF_NO_ERROR) {
+		munmap(p_storage->p_data, p_storage->mapped_size);
+		p_storage->p_data = NULL;
+	}
+
+	return ret;
+}
+
+int circularBufferStorage_free(circularBufferStorage_t *p_storage)
+{
+	VERIFY_ADDR(p_storage);
+	VERIFY_ADDR(p_storage->p_data);
+
+	if (munmap(p_storage->p_data, p_storage->mapped_size) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	p_storage->p_data = NULL;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferStorage_trim(const circularBuffer_t *p_buffer, const circularBufferStorage_t *p_storage, size_t min_bytes, bool lazy, size_t *p_released)
+{
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t total;
+	size_t first;
+	size_t free_bytes;
+	size_t released = 0;
+	int advice = MADV_DONTNEED;
+	int ret;
+
+	VERIFY_ADDR(p_buffer);
+
+	if (p_storage != NULL) {
+		VERIFY_SIZE(p_storage->page_size);
+		page = p_storage->page_size;
+		/* hugetlb mappings reject MADV_FREE */
+		if (p_storage->flags & CIRC_BUF_STORAGE_HUGETLB) {
+			lazy = false;
+		}
+	}
+
+#ifdef MADV_FREE
+	if (lazy) {
+		advice = MADV_FREE;
+	}
+#else
+	(void)lazy;
+#endif
+
+	total = p_buffer->buffer_slots * p_buffer->data_size;
+	first = p_buffer->end * p_buffer->data_size;
+	free_bytes = (p_buffer->buffer_slots - p_buffer->count) * p_buffer->data_size;
+
+	/* the free region runs from end to start, wrapping at most once */
+	if (free_bytes > total - first) {
+		ret = storage_release(p_buffer->p_data_location + first, p_buffer->p_data_location + total, page, min_bytes, advice, &released);
+		if (CIRC_BUF_NO_ERROR == ret) {
+			ret = storage_release(p_buffer->p_data_location, p_buffer->p_data_location + free_bytes - (total - first), page, min_bytes, advice, &released);
+		}
+	} else {
+		ret = storage_release(p_buffer->p_data_location + first, p_buffer->p_data_location + first + free_bytes, page, min_bytes, advice, &released);
+	}
+
+	if (p_released != NULL) {
+		*p_released = released;
+	}
+
+	return ret;
+}
+
+void circularBufferStorage_trim_on_low(void *p_context, const circularBuffer_t *p_buffer, unsigned int event)
+{
+	circularBufferTrim_t *p_trim = p_context;
+	size_t released = 0;
+
+	if (NULL == p_trim || event != CIRC_BUF_WATERMARK_LOW) {
+		return;
+	}
+
+	p_trim->result = circularBufferStorage_trim(p_buffer, p_trim->p_storage, p_trim->min_bytes, p_trim->lazy, &released);
+	p_trim->released += released;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static size_t storage_huge_page_size(void)
+{
+	FILE *p_file = fopen("/proc/meminfo", "r");
+	char line[128];
+	unsigned long kib;
+	size_t result = STORAGE_DEFAULT_HUGE_PAGE;
+
+	if (NULL == p_file) {
+		return result;
+	}
+	while (fgets(line, sizeof(line), p_file) != NULL) {
+		if (1 == sscanf(line, "Hugepagesize: %lu kB", &kib)) {
+			result = (size_t)kib * 1024u;
+			break;
+		}
+	}
+	fclose(p_file);
+
+	return result;
+}
+
+static size_t storage_round_up(size_t size, size_t page)
+{
+	return (size + page - 1) / page * page;
+}
+
+/* map \p size bytes starting on a multiple of \p alignment */
+static void *storage_map_aligned(size_t size, size_t alignment)
+{
+	uint8_t *p_map;
+	size_t head;
+
+	p_map = mmap(NULL, size + alignment, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (MAP_FAILED == p_map) {
+		return MAP_FAILED;
+	}
+
+	head = (alignment - (uintptr_t)p_map % alignment) % alignment;
+	if (head != 0) {
+		munmap(p_map, head);
+	}
+	munmap(p_map + head + size, alignment - head);
+
+	return p_map + head;
+}
+
+static int storage_setup(circularBufferStorage_t *p_storage, size_t page, unsigned int flags)
+{
+	if (p_storage->node != CIRC_BUF_STORAGE_ANY_NODE) {
+		if (storage_bind(p_storage->p_data, p_storage->mapped_size, p_storage->node) != 0) {
+			return CIRC_BUF_IO_ERROR;
+		}
+	}
+
+	if (flags & CIRC_BUF_STORAGE_MLOCK) {
+		if (mlock(p_storage->p_data, p_storage->mapped_size) != 0) {
+			return CIRC_BUF_IO_ERROR;
+		}
+		p_storage->flags |= CIRC_BUF_STORAGE_MLOCK;
+	}
+
+	if (flags & CIRC_BUF_STORAGE_PREFAULT) {
+		storage_prefault(p_storage->p_data, p_storage->mapped_size, page);
+		p_storage->flags |= CIRC_BUF_STORAGE_PREFAULT;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+static int storage_bind(void *p_data, size_t size, int node)
+{
+#ifdef SYS_mbind
+	unsigned long mask[CIRC_BUF_STORAGE_MAX_NODES / STORAGE_MASK_BITS];
+
+	memset(mask, 0, sizeof(mask));
+	mask[(size_t)node / STORAGE_MASK_BITS] = 1ul << ((size_t)node % STORAGE_MASK_BITS);
+	/* the kernel reads one bit fewer than maxnode */
+	return (int)syscall(SYS_mbind, p_data, size, STORAGE_MPOL_BIND, mask, (unsigned long)CIRC_BUF_STORAGE_MAX_NODES + 1, 0u);
+#else
+	(void)p_data;
+	(void)size;
+	(void)node;
+	return -1;
+#endif
+}
+
+static void storage_prefault(void *p_data, size_t size, size_t page)
+{
+	volatile uint8_t *p_byte = p_data;
+	size_t offset;
+
+#ifdef MADV_POPULATE_WRITE
+	if (0 == madvise(p_data, size, MADV_POPULATE_WRITE)) {
+		return;
+	}
+#endif
+	/* fresh anonymous pages are zero, so writing zero only faults them in */
+	for (offset = 0; offset < size; offset += page) {
+		p_byte[offset] = 0;
+	}
+}
+
+/* release the whole pages between \p p_begin and \p p_end */
+static int storage_release(uint8_t *p_begin, uint8_t *p_end, size_t page, size_t min_bytes, int advice, size_t *p_released)
+{
+	uintptr_t begin = ((uintptr_t)p_begin + page - 1) / page * page;
+	uintptr_t end = (uintptr_t)p_end / page * page;
+
+	if (end <= begin || end - begin < min_bytes) {
+		return CIRC_BUF_NO_ERROR;
+	}
+	if (madvise((void *)begin, end - begin, advice) != 0) {
+		return CIRC_BUF_IO_ERROR;
+	}
+	*p_released += end - begin;
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
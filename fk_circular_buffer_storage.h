@@ -0,0 +1,164 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_storage.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Huge-page, NUMA-placed and prefaulted storage for large buffers
+ * @details The core never allocates; this helper maps storage to pass to
+ * circularBuffer_init. Storage can be backed by explicit huge pages
+ * (`MAP_HUGETLB`), falling back to transparent huge pages, bound to one NUMA
+ * node, locked in memory and faulted in before it is returned. The first lap
+ * of a new buffer then costs no page faults and its pages are all local to
+ * the chosen node. Free regions of a mostly idle buffer can be returned to
+ * the kernel with circularBufferStorage_trim, either directly or from a low
+ * watermark.<br>
+ * Requires Linux.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_STORAGE_INCLUDED
+#define _CIRCULARBUFFER_STORAGE_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Try explicit huge pages first, falling back to transparent huge pages */
+#define CIRC_BUF_STORAGE_HUGETLB 0x1u
+/** Ask for transparent huge pages */
+#define CIRC_BUF_STORAGE_THP 0x2u
+/** Lock the storage in memory */
+#define CIRC_BUF_STORAGE_MLOCK 0x4u
+/** Fault every page in before returning */
+#define CIRC_BUF_STORAGE_PREFAULT 0x8u
+
+/** Pass as the node to leave placement to the kernel */
+#define CIRC_BUF_STORAGE_ANY_NODE (-1)
+/** Highest NUMA node number plus one that can be requested */
+#define CIRC_BUF_STORAGE_MAX_NODES 1024
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Mapped storage */
+typedef struct circularBufferStorage{
+	void *p_data; /**< Start of the storage; pass to circularBuffer_init */
+	size_t size; /**< Size requested */
+	size_t mapped_size; /**< Size mapped, rounded up to whole pages */
+	size_t page_size; /**< Size of the pages backing the storage */
+	unsigned int flags; /**< The `CIRC_BUF_STORAGE_*` features that took effect */
+	int node; /**< NUMA node the storage is bound to, or `CIRC_BUF_STORAGE_ANY_NODE` */
+} circularBufferStorage_t;
+
+/** Settings and results for circularBufferStorage_trim_on_low */
+typedef struct circularBufferTrim{
+	const circularBufferStorage_t *p_storage; /**< As for circularBufferStorage_trim */
+	size_t min_bytes; /**< As for circularBufferStorage_trim */
+	bool lazy; /**< As for circularBufferStorage_trim */
+	size_t released; /**< Bytes released so far; may be reset by the caller */
+	int result; /**< Result of the most recent trim */
+} circularBufferTrim_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Map \p size bytes of storage.
+ *
+ * `CIRC_BUF_STORAGE_HUGETLB` and `CIRC_BUF_STORAGE_THP` are hints: if no huge
+ * pages are available the storage is backed by normal pages, and
+ * \p p_storage->flags records what was obtained. A NUMA binding,
+ * `CIRC_BUF_STORAGE_MLOCK` and `CIRC_BUF_STORAGE_PREFAULT` are applied or the
+ * call fails. The binding is made before any page is faulted in, so every
+ * page is allocated on \p node.
+ *
+ * @param[out] p_storage storage to initialize
+ * @param[in] size bytes needed
+ * @param[in] node NUMA node to bind to, or `CIRC_BUF_STORAGE_ANY_NODE`
+ * @param[in] flags `CIRC_BUF_STORAGE_*` flags
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_storage is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p size is 0, or \p node is not
+ 	`CIRC_BUF_STORAGE_ANY_NODE` and outside [0, `CIRC_BUF_STORAGE_MAX_NODES`)
+ * @retval CIRC_BUF_IO_ERROR if the storage cannot be mapped, bound, locked or
+ 	faulted in; nothing is left mapped
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferStorage_alloc(circularBufferStorage_t *p_storage, size_t size, int node, unsigned int flags);
+
+/**
+ * Unmap storage from circularBufferStorage_alloc. Any buffer using it must no
+ * longer be used.
+ *
+ * @param[in] p_storage storage
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_storage is `NULL`
+ * @retval CIRC_BUF_IO_ERROR if the storage could not be unmapped
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferStorage_free(circularBufferStorage_t *p_storage);
+
+/**
+ * Return the pages of the free region of \p p_buffer, between `end` and
+ * `start`, to the kernel. Only whole pages inside the free region are
+ * released, and only from runs of at least \p min_bytes, so a buffer that
+ * drains a little at a time does not release and refault the same pages.
+ * Items in the buffer are not touched. Until a released page is next written
+ * its contents are unspecified: private pages released with `MADV_DONTNEED`
+ * read as zeroes, pages released lazily may keep their old contents until
+ * the kernel reclaims them, and shared mappings keep their contents.
+ *
+ * Pass the storage the buffer lives in as \p p_storage so whole pages are
+ * counted in its page size. Explicit huge pages are released in huge pages
+ * and never lazily, as the kernel does not support `MADV_FREE` for them; kernels
+ * before 5.18 do not release them at all. With \p p_storage `NULL`, any storage
+ * aligned to the system page size can be trimmed, not only storage from
+ * circularBufferStorage_alloc. Locked storage cannot be trimmed.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[in] p_storage storage backing \p p_buffer, or `NULL` for storage
+ 	backed by system pages
+ * @param[in] min_bytes smallest run of free whole pages worth releasing
+ * @param[in] lazy use `MADV_FREE` where available, which lets the kernel
+ 	reclaim the pages only under memory pressure; otherwise `MADV_DONTNEED`
+ 	releases them at once
+ * @param[out] p_released bytes released by this call. May be `NULL`.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p p_storage has no page size
+ * @retval CIRC_BUF_IO_ERROR if the kernel refused a release
+ * @retval CIRC_BUF_NO_ERROR on success, including when nothing was released
+ ******************************************************************************/
+int circularBufferStorage_trim(const circularBuffer_t *p_buffer, const circularBufferStorage_t *p_storage, size_t min_bytes, bool lazy, size_t *p_released);
+
+/**
+ * `circularBuffer_watermark_cb_t` that calls circularBufferStorage_trim when
+ * the count falls to the low watermark. Pass a `circularBufferTrim_t` as the
+ * watermark's `p_context`. The gap between the high and low watermarks keeps a
+ * buffer that hovers around one level from trimming repeatedly.
+ ******************************************************************************/
+void circularBufferStorage_trim_on_low(void *p_context, const circularBuffer_t *p_buffer, unsigned int event);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
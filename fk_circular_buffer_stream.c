@@ -0,0 +1,151 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_stream.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Cache-bypassing copy for very large transfers
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_stream.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STREAM_X86 1
+#include <immintrin.h>
+#endif
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+/* how far ahead of the loads to prefetch the source */
+#define STREAM_PREFETCH_DISTANCE 512
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+#ifdef STREAM_X86
+static size_t stream_align(uint8_t *dst, const uint8_t *src, size_t num, size_t alignment);
+static void stream_sse2(uint8_t *dst, const uint8_t *src, size_t num);
+static void stream_avx(uint8_t *dst, const uint8_t *src, size_t num);
+#endif
+
+/*-------------------------GLOBAL VARIABLES---------------------------------*/
+static size_t stream_threshold = CIRC_BUF_STREAM_THRESHOLD;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+void *circularBufferStream_memcpy(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num)
+{
+	if (num < stream_threshold) {
+		return memcpy(dst, src, num);
+	}
+
+#ifdef STREAM_X86
+	switch (circularBufferStream_level()) {
+	case CIRC_BUF_STREAM_AVX:
+		stream_avx(dst, src, num);
+		return dst;
+	case CIRC_BUF_STREAM_SSE2:
+		stream_sse2(dst, src, num);
+		return dst;
+	default:
+		break;
+	}
+#endif
+
+	return memcpy(dst, src, num);
+}
+
+void circularBufferStream_set_threshold(size_t threshold)
+{
+	stream_threshold = threshold;
+}
+
+circularBufferStreamLevel_t circularBufferStream_level(void)
+{
+#ifdef STREAM_X86
+	if (__builtin_cpu_supports("avx")) {
+		return CIRC_BUF_STREAM_AVX;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return CIRC_BUF_STREAM_SSE2;
+	}
+#endif
+	return CIRC_BUF_STREAM_NONE;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+#ifdef STREAM_X86
+/* copy the bytes before the first \p alignment boundary of \p dst with memcpy */
+static size_t stream_align(uint8_t *dst, const uint8_t *src, size_t num, size_t alignment)
+{
+	size_t head = (alignment - ((uintptr_t)dst & (alignment - 1))) & (alignment - 1);
+
+	if (head > num) {
+		head = num;
+	}
+	memcpy(dst, src, head);
+	return head;
+}
+
+__attribute__((target("sse2")))
+static void stream_sse2(uint8_t *dst, const uint8_t *src, size_t num)
+{
+	size_t done = stream_align(dst, src, num, 16);
+
+	for (; num - done >= 64; done += 64) {
+		_mm_prefetch((const char *)src + done + STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_stream_si128((__m128i *)(void *)(dst + done), _mm_loadu_si128((const __m128i *)(const void *)(src + done)));
+		_mm_stream_si128((__m128i *)(void *)(dst + done + 16), _mm_loadu_si128((const __m128i *)(const void *)(src + done + 16)));
+		_mm_stream_si128((__m128i *)(void *)(dst + done + 32), _mm_loadu_si128((const __m128i *)(const void *)(src + done + 32)));
+		_mm_stream_si128((__m128i *)(void *)(dst + done + 48), _mm_loadu_si128((const __m128i *)(const void *)(src + done + 48)));
+	}
+	/* order the streaming stores before anything that publishes the data */
+	_mm_sfence();
+	memcpy(dst + done, src + done, num - done);
+}
+
+__attribute__((target("avx")))
+static void stream_avx(uint8_t *dst, const uint8_t *src, size_t num)
+{
+	size_t done = stream_align(dst, src, num, 32);
+
+	for (; num - done >= 128; done += 128) {
+		_mm_prefetch((const char *)src + done + STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_prefetch((const char *)src + done + STREAM_PREFETCH_DISTANCE + 64, _MM_HINT_NTA);
+		_mm256_stream_si256((__m256i *)(void *)(dst + done), _mm256_loadu_si256((const __m256i *)(const void *)(src + done)));
+		_mm256_stream_si256((__m256i *)(void *)(dst + done + 32), _mm256_loadu_si256((const __m256i *)(const void *)(src + done + 32)));
+		_mm256_stream_si256((__m256i *)(void *)(dst + done + 64), _mm256_loadu_si256((const __m256i *)(const void *)(src + done + 64)));
+		_mm256_stream_si256((__m256i *)(void *)(dst + done + 96), _mm256_loadu_si256((const __m256i *)(const void *)(src + done + 96)));
+	}
+	_mm_sfence();
+	memcpy(dst + done, src + done, num - done);
+}
+#endif
+
+
+/*-------------------------EOF----------------------------------------------*/
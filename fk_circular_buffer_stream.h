@@ -0,0 +1,91 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_stream.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Cache-bypassing copy for very large transfers
+ * @details circularBufferStream_memcpy has the signature of memcpy_t. Pass it
+ * as the `fp_memcpy` argument of any buffer operation that moves large batches.
+ * Copies shorter than the threshold go to `memcpy`. Longer copies use
+ * non-temporal stores with software prefetch, so the destination does not
+ * evict the working set of other threads sharing the cache. AVX or SSE2 is
+ * chosen at run time on x86; elsewhere every copy goes to `memcpy`.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_STREAM_INCLUDED
+#define _CIRCULARBUFFER_STREAM_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+/** Default size in bytes from which circularBufferStream_memcpy bypasses the cache */
+#define CIRC_BUF_STREAM_THRESHOLD (256u * 1024u)
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Copy routine selected by circularBufferStream_memcpy for large copies */
+typedef enum circularBufferStreamLevel{
+	CIRC_BUF_STREAM_NONE, /**< `memcpy` */
+	CIRC_BUF_STREAM_SSE2, /**< 16-byte non-temporal stores */
+	CIRC_BUF_STREAM_AVX   /**< 32-byte non-temporal stores */
+} circularBufferStreamLevel_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Copy \p num bytes from \p src to \p dst, bypassing the cache for the
+ * destination when \p num is at least the threshold. The regions must not
+ * overlap.
+ *
+ * @param[out] dst destination
+ * @param[in] src source
+ * @param[in] num number of bytes
+ * @return \p dst
+ ******************************************************************************/
+void *circularBufferStream_memcpy(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num);
+
+/**
+ * Set the size in bytes from which circularBufferStream_memcpy bypasses the
+ * cache. The default is `CIRC_BUF_STREAM_THRESHOLD`. Call before any thread
+ * starts copying.
+ *
+ * @param[in] threshold size in bytes
+ ******************************************************************************/
+void circularBufferStream_set_threshold(size_t threshold);
+
+/**
+ * Report which copy routine this machine uses for large copies
+ *
+ * @return the selected circularBufferStreamLevel_t
+ ******************************************************************************/
+circularBufferStreamLevel_t circularBufferStream_level(void);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,242 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_transform.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Pop items through a conversion kernel instead of memcpy
+ * @details Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_transform.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static int transform_pop(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t granularity, size_t *p_popped, circularBuffer_transform_t fp_kernel, void *p_context);
+static uint16_t transform_swap16(uint16_t value);
+static uint32_t transform_swap32(uint32_t value);
+static uint64_t transform_swap64(uint64_t value);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferTransform_popFIFO_n(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t *p_popped, circularBuffer_transform_t fp_kernel, void *p_context)
+{
+	return transform_pop(p_buffer, p_dst, n, 1, p_popped, fp_kernel, p_context);
+}
+
+int circularBufferTransform_popFIFO_planes(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t *p_popped, const circularBufferTransformPlanes_t *p_planes)
+{
+	VERIFY_ADDR(p_planes);
+	if (0 == p_planes->channels) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	return transform_pop(p_buffer, p_dst, n, p_planes->channels, p_popped, circularBufferTransform_deinterleave, (void *)p_planes);
+}
+
+int circularBufferTransform_s16_to_float(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size)
+{
+	const circularBufferTransformScale_t *p_scale = p_context;
+	float *p_out = (float *)p_dst + index;
+	float scale;
+	float offset;
+	int16_t sample;
+	size_t i;
+
+	VERIFY_ADDR(p_scale);
+	if (item_size != sizeof(int16_t)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	/* locals, so the stores to p_out cannot be taken to change them */
+	scale = p_scale->scale;
+	offset = p_scale->offset;
+	for (i = 0; i < n; i++) {
+		memcpy(&sample, p_src + i * sizeof(sample), sizeof(sample));
+		p_out[i] = (float)sample * scale + offset;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferTransform_s32_to_float(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size)
+{
+	const circularBufferTransformScale_t *p_scale = p_context;
+	float *p_out = (float *)p_dst + index;
+	float scale;
+	float offset;
+	int32_t sample;
+	size_t i;
+
+	VERIFY_ADDR(p_scale);
+	if (item_size != sizeof(int32_t)) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	/* locals, so the stores to p_out cannot be taken to change them */
+	scale = p_scale->scale;
+	offset = p_scale->offset;
+	for (i = 0; i < n; i++) {
+		memcpy(&sample, p_src + i * sizeof(sample), sizeof(sample));
+		p_out[i] = (float)sample * scale + offset;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferTransform_bswap(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size)
+{
+	uint8_t *p_out = (uint8_t *)p_dst + index * item_size;
+	uint16_t value16;
+	uint32_t value32;
+	uint64_t value64;
+	size_t i;
+
+	(void)p_context;
+
+	switch (item_size) {
+	case sizeof(uint16_t):
+		for (i = 0; i < n; i++) {
+			memcpy(&value16, p_src + i * item_size, item_size);
+			value16 = transform_swap16(value16);
+			memcpy(p_out + i * item_size, &value16, item_size);
+		}
+		break;
+	case sizeof(uint32_t):
+		for (i = 0; i < n; i++) {
+			memcpy(&value32, p_src + i * item_size, item_size);
+			value32 = transform_swap32(value32);
+			memcpy(p_out + i * item_size, &value32, item_size);
+		}
+		break;
+	case sizeof(uint64_t):
+		for (i = 0; i < n; i++) {
+			memcpy(&value64, p_src + i * item_size, item_size);
+			value64 = transform_swap64(value64);
+			memcpy(p_out + i * item_size, &value64, item_size);
+		}
+		break;
+	default:
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferTransform_deinterleave(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size)
+{
+	const circularBufferTransformPlanes_t *p_planes = p_context;
+	uint8_t *p_out = p_dst;
+	size_t channel;
+	size_t frame;
+	size_t i;
+
+	VERIFY_ADDR(p_planes);
+	if (0 == p_planes->channels || (index + n - 1) / p_planes->channels >= p_planes->plane_items) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	channel = index % p_planes->channels;
+	frame = index / p_planes->channels;
+	for (i = 0; i < n; i++) {
+		memcpy(p_out + (channel * p_planes->plane_items + frame) * item_size, p_src + i * item_size, item_size);
+		channel++;
+		if (channel == p_planes->channels) {
+			channel = 0;
+			frame++;
+		}
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+/* pop up to \p n items, in whole multiples of \p granularity */
+static int transform_pop(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t granularity, size_t *p_popped, circularBuffer_transform_t fp_kernel, void *p_context)
+{
+	circularBufferSpan_t spans[2];
+	size_t first_items;
+	int ret;
+
+	VERIFY_ADDR(p_buffer);
+	VERIFY_ADDR(p_dst);
+	VERIFY_ADDR(fp_kernel);
+
+	if (p_popped != NULL) {
+		*p_popped = 0;
+	}
+	if (n > p_buffer->count) {
+		n = p_buffer->count;
+	}
+	n -= n % granularity;
+	if (0 == n) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	circularBuffer_peek_spans(p_buffer, 0, n, spans, NULL);
+	first_items = spans[0].size / p_buffer->data_size;
+	ret = fp_kernel(p_context, p_dst, 0, spans[0].p_data, first_items, p_buffer->data_size);
+	if (CIRC_BUF_NO_ERROR == ret && spans[1].size != 0) {
+		ret = fp_kernel(p_context, p_dst, first_items, spans[1].p_data, n - first_items, p_buffer->data_size);
+	}
+	if (ret != CIRC_BUF_NO_ERROR) {
+		return ret;
+	}
+
+	circularBuffer_remove_records(p_buffer, n);
+	if (p_popped != NULL) {
+		*p_popped = n;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+static uint16_t transform_swap16(uint16_t value)
+{
+	return (uint16_t)((value >> 8) | (value << 8));
+}
+
+static uint32_t transform_swap32(uint32_t value)
+{
+	return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8)
+		| ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+}
+
+static uint64_t transform_swap64(uint64_t value)
+{
+	return ((uint64_t)transform_swap32((uint32_t)value) << 32) | transform_swap32((uint32_t)(value >> 32));
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,143 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+
+/**
+ * @file fk_circular_buffer_transform.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Pop items through a conversion kernel instead of memcpy
+ * @details circularBufferTransform_popFIFO_n hands each contiguous region of
+ * the popped items to a kernel that writes the converted output directly, so
+ * converting a batch costs one pass over the data instead of a copy and a
+ * second pass. Built-in kernels convert `int16_t` or `int32_t` samples to
+ * scaled `float`, reverse byte order, and split interleaved channels into
+ * planes. Their loops are simple enough for the compiler to vectorize.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_TRANSFORM_INCLUDED
+#define _CIRCULARBUFFER_TRANSFORM_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/**
+ * Conversion kernel. Converts \p n items of \p item_size bytes at \p p_src,
+ * which are items \p index to `index + n - 1` of the batch, and writes the
+ * results to their places in the output \p p_dst. Returns `CIRC_BUF_NO_ERROR`,
+ * or an error code to abandon the pop.
+ */
+typedef int (* circularBuffer_transform_t)(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size);
+
+/** Context for the `*_to_float` kernels: `out = in * scale + offset` */
+typedef struct circularBufferTransformScale{
+	float scale; /**< Multiplier */
+	float offset; /**< Added after scaling */
+} circularBufferTransformScale_t;
+
+/** Context for circularBufferTransform_deinterleave */
+typedef struct circularBufferTransformPlanes{
+	size_t channels; /**< Channels per frame */
+	size_t plane_items; /**< Items between the start of one plane and the next in the output */
+} circularBufferTransformPlanes_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Pop up to \p n items, passing them through \p fp_kernel. The kernel is
+ * called once per contiguous region, at most twice. If it fails, nothing is
+ * removed from \p p_buffer.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[out] p_dst output, laid out as \p fp_kernel expects
+ * @param[in] n maximum number of items to pop
+ * @param[out] p_popped number of items popped. May be `NULL`.
+ * @param[in] fp_kernel conversion kernel
+ * @param[in] p_context passed to \p fp_kernel
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer, \p p_dst or \p fp_kernel is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer is empty or \p n is zero
+ * @retval others as returned by \p fp_kernel
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferTransform_popFIFO_n(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t *p_popped, circularBuffer_transform_t fp_kernel, void *p_context);
+
+/**
+ * Pop up to \p n items, rounded down to whole frames of `channels` items,
+ * through circularBufferTransform_deinterleave. A partial frame at the end of
+ * \p p_buffer is left for a later pop, so the channels of the frames after it
+ * stay in their planes.
+ *
+ * @param[in] p_buffer pointer to the circular buffer
+ * @param[out] p_dst planes, as for circularBufferTransform_deinterleave
+ * @param[in] n maximum number of items to pop
+ * @param[out] p_popped number of items popped. May be `NULL`.
+ * @param[in] p_planes layout of \p p_dst
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_buffer, \p p_dst or \p p_planes is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if `channels` is 0 or the frames do not fit
+ * @retval CIRC_BUF_BUFFER_EMPTY if \p p_buffer or \p n holds less than one frame
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferTransform_popFIFO_planes(circularBuffer_t *p_buffer, void *p_dst, size_t n, size_t *p_popped, const circularBufferTransformPlanes_t *p_planes);
+
+/**
+ * Kernel converting `int16_t` items to `float`, with a
+ * `circularBufferTransformScale_t` context. Output item `i` is `((float *)p_dst)[i]`.
+ *
+ * @retval CIRC_BUF_SIZE_ERROR if the item size is not `sizeof(int16_t)`
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_context is `NULL`
+ ******************************************************************************/
+int circularBufferTransform_s16_to_float(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size);
+
+/**
+ * As circularBufferTransform_s16_to_float, for `int32_t` items
+ ******************************************************************************/
+int circularBufferTransform_s32_to_float(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size);
+
+/**
+ * Kernel reversing the byte order of 2, 4 or 8-byte items. No context is used.
+ *
+ * @retval CIRC_BUF_SIZE_ERROR for any other item size
+ ******************************************************************************/
+int circularBufferTransform_bswap(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size);
+
+/**
+ * Kernel splitting items interleaved by channel (`L R L R ...`) into planes
+ * (`L L ... R R ...`), with a `circularBufferTransformPlanes_t` context. Item
+ * `i` of the batch goes to position `i / channels` of plane `i % channels`.
+ * Pop a whole number of frames, at most `plane_items` of them, with
+ * circularBufferTransform_popFIFO_planes.
+ *
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_context is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if `channels` is 0 or the batch does not fit
+ ******************************************************************************/
+int circularBufferTransform_deinterleave(void *p_context, void * FK_CB_KW_RESTRICT p_dst, size_t index, const uint8_t * FK_CB_KW_RESTRICT p_src, size_t n, size_t item_size);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
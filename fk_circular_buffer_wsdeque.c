@@ -0,0 +1,181 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_wsdeque.c
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Bounded work-stealing deque over fixed-size slots
+ * @details Follows Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013), with a fixed capacity
+ * instead of a growable array.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+*/
+
+/*-------------------------MODULES USED-------------------------------------*/
+#include <string.h>
+#include "fk_circular_buffer_wsdeque.h"
+/*-------------------------DEFINITIONS AND MACORS---------------------------*/
+
+#define VERIFY_ADDR(addr) {if(NULL==addr){return CIRC_BUF_ADDR_ERROR;}}
+#define VERIFY_SIZE(size) {if(0==size){return CIRC_BUF_SIZE_ERROR;}}
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+
+
+/*-------------------------PROTOTYPES OF LOCAL FUNCTIONS--------------------*/
+static uint8_t *wsdeque_slot(const circularBufferWsDeque_t *p_deque, int64_t position);
+
+
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+int circularBufferWsDeque_init(circularBufferWsDeque_t *p_deque, void *p_data_buffer, size_t data_buffer_size, size_t item_size)
+{
+	VERIFY_ADDR(p_deque);
+	VERIFY_ADDR(p_data_buffer);
+	VERIFY_SIZE(data_buffer_size);
+	VERIFY_SIZE(item_size);
+
+	if (data_buffer_size % item_size != 0) {
+		return CIRC_BUF_SIZE_ERROR;
+	}
+
+	p_deque->data_size = item_size;
+	p_deque->buffer_slots = data_buffer_size / item_size;
+	p_deque->p_data_location = p_data_buffer;
+	atomic_init(&p_deque->top, 0);
+	atomic_init(&p_deque->bottom, 0);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferWsDeque_push(circularBufferWsDeque_t *p_deque, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	int64_t bottom;
+	int64_t top;
+
+	VERIFY_ADDR(p_deque);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	bottom = atomic_load_explicit(&p_deque->bottom, memory_order_relaxed);
+	top = atomic_load_explicit(&p_deque->top, memory_order_acquire);
+	if ((uint64_t)(bottom - top) >= p_deque->buffer_slots) {
+		return CIRC_BUF_BUFFER_FULL;
+	}
+
+	fp_memcpy(wsdeque_slot(p_deque, bottom), p_data, p_deque->data_size);
+	/* the item must be visible before thieves can see the new bottom */
+	atomic_thread_fence(memory_order_release);
+	atomic_store_explicit(&p_deque->bottom, bottom + 1, memory_order_relaxed);
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferWsDeque_popLIFO(circularBufferWsDeque_t *p_deque, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	int64_t bottom;
+	int64_t top;
+	int ret = CIRC_BUF_NO_ERROR;
+
+	VERIFY_ADDR(p_deque);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	bottom = atomic_load_explicit(&p_deque->bottom, memory_order_relaxed) - 1;
+	atomic_store_explicit(&p_deque->bottom, bottom, memory_order_relaxed);
+	/* publish the claim on the tail item before looking at the head */
+	atomic_thread_fence(memory_order_seq_cst);
+	top = atomic_load_explicit(&p_deque->top, memory_order_relaxed);
+
+	if (top > bottom) {
+		atomic_store_explicit(&p_deque->bottom, bottom + 1, memory_order_relaxed);
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	if (top == bottom) {
+		/* last item: race any thief for it */
+		if (!atomic_compare_exchange_strong_explicit(&p_deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+			ret = CIRC_BUF_BUFFER_EMPTY;
+		}
+		atomic_store_explicit(&p_deque->bottom, bottom + 1, memory_order_relaxed);
+	}
+
+	if (CIRC_BUF_NO_ERROR == ret) {
+		fp_memcpy(p_data, wsdeque_slot(p_deque, bottom), p_deque->data_size);
+	}
+
+	return ret;
+}
+
+int circularBufferWsDeque_steal(circularBufferWsDeque_t *p_deque, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy)
+{
+	int64_t top;
+	int64_t bottom;
+
+	VERIFY_ADDR(p_deque);
+	fp_memcpy = fp_memcpy ? fp_memcpy : memcpy;
+
+	top = atomic_load_explicit(&p_deque->top, memory_order_acquire);
+	atomic_thread_fence(memory_order_seq_cst);
+	bottom = atomic_load_explicit(&p_deque->bottom, memory_order_acquire);
+
+	if (top >= bottom) {
+		return CIRC_BUF_BUFFER_EMPTY;
+	}
+
+	/*
+	 * Copy before claiming: the slot can only be reused after top moves past
+	 * it, in which case the compare-and-swap below fails and the copy is
+	 * discarded.
+	 */
+	fp_memcpy(p_data, wsdeque_slot(p_deque, top), p_deque->data_size);
+	if (!atomic_compare_exchange_strong_explicit(&p_deque->top, &top, top + 1, memory_order_seq_cst, memory_order_relaxed)) {
+		return CIRC_BUF_RETRY_ERROR;
+	}
+
+	return CIRC_BUF_NO_ERROR;
+}
+
+int circularBufferWsDeque_getCount(const circularBufferWsDeque_t *p_deque, size_t *result)
+{
+	int64_t bottom;
+	int64_t top;
+
+	VERIFY_ADDR(p_deque);
+	VERIFY_ADDR(result);
+
+	bottom = atomic_load_explicit(&p_deque->bottom, memory_order_relaxed);
+	top = atomic_load_explicit(&p_deque->top, memory_order_relaxed);
+	*result = bottom > top ? (size_t)(bottom - top) : 0;
+
+	return CIRC_BUF_NO_ERROR;
+}
+/*-------------------------LOCAL FUNCTIONS-----------------------------------*/
+static uint8_t *wsdeque_slot(const circularBufferWsDeque_t *p_deque, int64_t position)
+{
+	return p_deque->p_data_location + ((uint64_t)position % p_deque->buffer_slots) * p_deque->data_size;
+}
+
+
+/*-------------------------EOF----------------------------------------------*/
@@ -0,0 +1,133 @@
+/****************************************************************************
+ * Copyright (C) 2019 by Fictive Kin                                        *
+ *                                                                          *
+ * Permission is hereby granted, free of charge, to any person obtaining a  *
+ * copy of this software and associated documentation files                 *
+ * (the "Software"), to deal in the Software without restriction, including *
+ * without limitation the rights to use, copy, modify, merge, publish,      *
+ * distribute, sublicense, and/or sell copies of the Software, and to       *
+ * permit persons to whom the Software is furnished to do so, subject to    *
+ * the following conditions:                                                *
+ *                                                                          *
+ * The above copyright notice and this permission notice shall be included  *
+ * in all copies or substantial portions of the Software.                   *
+ *                                                                          *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS  *
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF               *
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.   *
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY     *
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,     *
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE        *
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                   *
+ ****************************************************************************/
+
+/**
+ * @file fk_circular_buffer_wsdeque.h
+ * @author Fictive Kin, LLC
+ * @version 1
+ * @date 18 Oct 2026
+ * @brief Bounded work-stealing deque over fixed-size slots
+ * @details A Chase-Lev deque. The owning thread pushes and pops at the tail
+ * (the circularBuffer_push / circularBuffer_popLIFO end) and any other thread
+ * may steal from the head (the circularBuffer_popFIFO end). Owner push uses
+ * no read-modify-write atomics; owner pop needs a compare-and-swap only when
+ * it races a thief for the last item. Thieves claim an item with one
+ * compare-and-swap.<br>
+ * Requires a C11 compiler with `<stdatomic.h>`.<br>
+ * Copyright (c) 2019, Fictive Kin, LLC<br>
+ * All rights reserved. <br>
+ *
+ */
+
+#ifndef _CIRCULARBUFFER_WSDEQUE_INCLUDED
+#define _CIRCULARBUFFER_WSDEQUE_INCLUDED
+/*-------------------------MODULES USED-------------------------------------*/
+
+#include <stdatomic.h>
+#include "fk_circular_buffer.h"
+
+/*-------------------------DEFINITIONS AND MACROS---------------------------*/
+
+/*-------------------------TYPEDEFS AND STRUCTURES--------------------------*/
+
+/** Work-stealing deque */
+typedef struct circularBufferWsDeque{
+	size_t data_size;  /**< Size of an individual element */
+	size_t buffer_slots; /**< Number of slots */
+	uint8_t *p_data_location;  /**< data pointer */
+	_Atomic int64_t top; /**< Items ever removed from the head; advanced by thieves */
+	_Atomic int64_t bottom; /**< Position after the tail item; moved by the owner */
+} circularBufferWsDeque_t;
+
+/*-------------------------EXPORTED FUNCTIONS-------------------------------*/
+/**
+ * Initialize a work-stealing deque. Arguments are as for circularBuffer_init.
+ *
+ * @param[in] p_deque pointer to the deque to initialize
+ * @param[in] p_data_buffer pointer to the storage
+ * @param[in] data_buffer_size size of \p p_data_buffer in bytes
+ * @param[in] item_size item size. \p data_buffer_size must be evenly divisible by
+ *								\p item_size
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_deque or \p p_data_buffer is `NULL`
+ * @retval CIRC_BUF_SIZE_ERROR if \p data_buffer_size or \p item_size is 0, or
+ *								if \p item_size does not evenly divide
+ *								\p data_buffer_size
+ * @retval CIRC_BUF_NO_ERROR on success
+ *
+ ******************************************************************************/
+int circularBufferWsDeque_init(circularBufferWsDeque_t *p_deque, void *p_data_buffer, size_t data_buffer_size, size_t item_size);
+
+/**
+ * Push 1 item onto the tail. Owner thread only.
+ *
+ * @param[in] p_deque pointer to the deque
+ * @param[in] p_data pointer to one item
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_deque is `NULL`
+ * @retval CIRC_BUF_BUFFER_FULL if the deque is full
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferWsDeque_push(circularBufferWsDeque_t *p_deque, const void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Pop 1 item from the tail. Owner thread only.
+ *
+ * @param[in] p_deque pointer to the deque
+ * @param[out] p_data destination for one item
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_deque is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the deque is empty, or a thief took the last item
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferWsDeque_popLIFO(circularBufferWsDeque_t *p_deque, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Steal 1 item from the head. Any thread.
+ *
+ * @param[in] p_deque pointer to the deque
+ * @param[out] p_data destination for one item. Its contents are unspecified
+ 	unless `CIRC_BUF_NO_ERROR` is returned.
+ * @param[in] fp_memcpy pointer to the function to use to copy memory. If `NULL` is
+ 	passed, `memcpy` will be used.
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_deque is `NULL`
+ * @retval CIRC_BUF_BUFFER_EMPTY if the deque is empty
+ * @retval CIRC_BUF_RETRY_ERROR if another thread took the item first
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferWsDeque_steal(circularBufferWsDeque_t *p_deque, void * FK_CB_KW_RESTRICT p_data, memcpy_t fp_memcpy);
+
+/**
+ * Get an estimate of the number of items. Exact when called by the owner
+ * with no concurrent thieves.
+ *
+ * @param[in] p_deque pointer to the deque
+ * @param[out] result number of items
+ * @retval CIRC_BUF_ADDR_ERROR if \p p_deque or \p result is `NULL`
+ * @retval CIRC_BUF_NO_ERROR on success
+ ******************************************************************************/
+int circularBufferWsDeque_getCount(const circularBufferWsDeque_t *p_deque, size_t *result);
+
+#endif
+/*-------------------------EOF----------------------------------------------*/
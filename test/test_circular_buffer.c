@@ -1,8 +1,25 @@
 #include "fk_circular_buffer.h"
+#include "fk_circular_buffer_agg.h"
+#include "fk_circular_buffer_drain.h"
+#include "fk_circular_buffer_shm.h"
+#include "fk_circular_buffer_seqlock.h"
+#include "fk_circular_buffer_latency.h"
+#include "fk_circular_buffer_wsdeque.h"
+#include "fk_circular_buffer_multicast.h"
+#include "fk_circular_buffer_coalesce.h"
+#include "fk_circular_buffer_compact.h"
+#include "fk_circular_buffer_stream.h"
+#include "fk_circular_buffer_parallel.h"
+#include "fk_circular_buffer_storage.h"
+#include "fk_circular_buffer_transform.h"
+#include "fk_circular_buffer_combine.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
 
 void test_init() {
 	circularBuffer_t buf;
@@ -483,6 +500,1837 @@ void test_wrapped_pop_fifo() {
 	assert(ret == CIRC_BUF_NO_ERROR);
 }
 
+void test_agg_window() {
+	circularBufferAgg_t agg;
+	int32_t storage[4];
+	size_t index[CIRC_BUF_AGG_INDEX_ENTRIES(4)];
+	int32_t samples[] = {5, 1, 4, 3, 2, 6};
+	int32_t value;
+	double result;
+	int ret;
+	unsigned int i;
+
+	ret = circularBufferAgg_init(&agg, CIRC_BUF_AGG_INT32, storage, sizeof(storage), index, sizeof(index) - 1);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferAgg_init(&agg, CIRC_BUF_AGG_INT32, storage, sizeof(storage), index, sizeof(index));
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	ret = circularBufferAgg_min(&agg, &value);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	ret = circularBufferAgg_push_n(&agg, samples, 4);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferAgg_push(&agg, &samples[4]);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+
+	circularBufferAgg_sum(&agg, &result);
+	assert(result == 13);
+	circularBufferAgg_min(&agg, &value);
+	assert(value == 1);
+	circularBufferAgg_max(&agg, &value);
+	assert(value == 5);
+
+	/* window slides over {1, 4, 3, 2} then {4, 3, 2, 6} */
+	for (i = 4; i < 6; i++) {
+		ret = circularBufferAgg_push_overwrite(&agg, &samples[i]);
+		assert(ret == CIRC_BUF_NO_ERROR);
+	}
+	circularBufferAgg_sum(&agg, &result);
+	assert(result == 15);
+	circularBufferAgg_min(&agg, &value);
+	assert(value == 2);
+	circularBufferAgg_max(&agg, &value);
+	assert(value == 6);
+	circularBufferAgg_mean(&agg, &result);
+	assert(result == 3.75);
+	circularBufferAgg_variance(&agg, &result);
+	assert(result > 2.18 && result < 2.19);
+
+	ret = circularBufferAgg_popFIFO(&agg, &value);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(value == 4);
+	ret = circularBufferAgg_remove_records(&agg, 2);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	circularBufferAgg_min(&agg, &value);
+	assert(value == 6);
+
+	ret = circularBufferAgg_popFIFO_n(&agg, storage, 10);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	circularBufferAgg_sum(&agg, &result);
+	assert(result == 0);
+	ret = circularBufferAgg_mean(&agg, &result);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+}
+
+void test_agg_double() {
+	circularBufferAgg_t agg;
+	double storage[3];
+	size_t index[CIRC_BUF_AGG_INDEX_ENTRIES(3)];
+	double samples[] = {-1.5, 2.5, 2.5, 0.5};
+	double value;
+	unsigned int i;
+
+	circularBufferAgg_init(&agg, CIRC_BUF_AGG_DOUBLE, storage, sizeof(storage), index, sizeof(index));
+	for (i = 0; i < 4; i++) {
+		circularBufferAgg_push_overwrite(&agg, &samples[i]);
+	}
+	circularBufferAgg_max(&agg, &value);
+	assert(value == 2.5);
+	circularBufferAgg_popFIFO(&agg, NULL);
+	circularBufferAgg_max(&agg, &value);
+	assert(value == 2.5);
+	circularBufferAgg_min(&agg, &value);
+	assert(value == 0.5);
+	circularBufferAgg_flush(&agg);
+	assert(circularBuffer_is_empty(&agg.buffer));
+}
+
+void test_agg_exact() {
+	circularBufferAgg_t agg;
+	int64_t storage[2];
+	double fstorage[4];
+	size_t index[CIRC_BUF_AGG_INDEX_ENTRIES(4)];
+	int64_t big = (int64_t)1 << 60;
+	int64_t one = 1;
+	int64_t sum;
+	double fsamples[] = {1e9 + 4, 1e9 + 7, 1e9 + 13, 1e9 + 16, 1e9 + 4};
+	double result;
+	unsigned int i;
+	int ret;
+
+	/* a sliding window must not keep the rounding error of items it dropped */
+	circularBufferAgg_init(&agg, CIRC_BUF_AGG_INT64, storage, sizeof(storage), index, sizeof(index));
+	circularBufferAgg_push(&agg, &big);
+	circularBufferAgg_push(&agg, &one);
+	circularBufferAgg_popFIFO(&agg, NULL);
+	ret = circularBufferAgg_sum_int64(&agg, &sum);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(sum == 1);
+	circularBufferAgg_sum(&agg, &result);
+	assert(result == 1);
+
+	/* the 128-bit accumulator carries past int64 and reports it */
+	big = INT64_MAX;
+	circularBufferAgg_flush(&agg);
+	circularBufferAgg_push(&agg, &big);
+	circularBufferAgg_push(&agg, &big);
+	ret = circularBufferAgg_sum_int64(&agg, &sum);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	circularBufferAgg_sum(&agg, &result);
+	assert(result == 2.0 * 9223372036854775807.0);
+	circularBufferAgg_popFIFO(&agg, NULL);
+	ret = circularBufferAgg_sum_int64(&agg, &sum);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(sum == INT64_MAX);
+	big = INT64_MIN;
+	circularBufferAgg_push_overwrite(&agg, &big);
+	ret = circularBufferAgg_sum_int64(&agg, &sum);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(sum == -1);
+
+	/* large offset, small spread: sum of squares would cancel to nothing */
+	circularBufferAgg_init(&agg, CIRC_BUF_AGG_DOUBLE, fstorage, sizeof(fstorage), index, sizeof(index));
+	ret = circularBufferAgg_sum_int64(&agg, &sum);
+	assert(ret == CIRC_BUF_FORMAT_ERROR);
+	for (i = 0; i < 5; i++) {
+		circularBufferAgg_push_overwrite(&agg, &fsamples[i]);
+	}
+	/* window is {1e9+7, 1e9+13, 1e9+16, 1e9+4} */
+	circularBufferAgg_mean(&agg, &result);
+	assert(result == 1e9 + 10);
+	circularBufferAgg_variance(&agg, &result);
+	assert(result > 22.5 - 1e-6 && result < 22.5 + 1e-6);
+}
+
+void test_peek_spans() {
+	circularBuffer_t buf;
+	char buf_storage[8];
+	char data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	circularBufferSpan_t spans[2];
+	size_t span_count;
+	int ret;
+
+	circularBuffer_init(&buf, buf_storage, sizeof(buf_storage), 2);
+	ret = circularBuffer_peek_spans(&buf, 0, 1, spans, &span_count);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	circularBuffer_push_n(&buf, data, 4, NULL);
+	circularBuffer_remove_records(&buf, 3);
+	circularBuffer_push_n(&buf, data, 2, NULL);
+
+	ret = circularBuffer_peek_spans(&buf, 0, 0, spans, &span_count);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBuffer_peek_spans(&buf, 0, 10, spans, &span_count);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(span_count == 2);
+	assert(spans[0].size == 2 && spans[0].p_data[0] == 6);
+	assert(spans[1].size == 4 && spans[1].p_data == (uint8_t *)buf_storage);
+
+	ret = circularBuffer_peek_spans(&buf, 1, 1, spans, &span_count);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(span_count == 1);
+	assert(spans[0].size == 2 && spans[0].p_data[0] == 0);
+
+	ret = circularBuffer_peek_spans(&buf, 3, 1, spans, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+}
+
+void test_drain() {
+	circularBuffer_t buf;
+	circularBufferDrain_t drain;
+	circularBufferDrainRecord_t records[2];
+	circularBufferDrainBatch_t first, second, third;
+	char buf_storage[8];
+	char data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	size_t res;
+	int ret;
+
+	circularBuffer_init(&buf, buf_storage, sizeof(buf_storage), 1);
+	ret = circularBufferDrain_init(&drain, &buf, records, 0);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferDrain_init(&drain, &buf, records, 2);
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	ret = circularBufferDrain_next(&drain, 4, &first);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	circularBuffer_push_n(&buf, data, 5, NULL);
+	ret = circularBufferDrain_next(&drain, 3, &first);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(first.items == 3 && first.spans[0].p_data[0] == 0);
+	ret = circularBufferDrain_next(&drain, 3, &second);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(second.items == 2 && second.spans[0].p_data[0] == 3);
+	ret = circularBufferDrain_next(&drain, 3, &third);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+
+	/* out-of-order completion keeps the items until the first batch is done */
+	ret = circularBufferDrain_complete(&drain, second.id);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	circularBuffer_getCount(&buf, &res);
+	assert(res == 5);
+	ret = circularBufferDrain_complete(&drain, first.id);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	circularBuffer_getCount(&buf, &res);
+	assert(res == 0);
+	circularBufferDrain_in_flight(&drain, &res);
+	assert(res == 0);
+	ret = circularBufferDrain_complete(&drain, first.id);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+
+	/* production overlaps with a batch in flight and wraps */
+	circularBuffer_push_n(&buf, data, 6, NULL);
+	ret = circularBufferDrain_next(&drain, 8, &third);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(third.items == 6 && third.span_count == 2);
+	circularBuffer_push_n(&buf, data, 2, NULL);
+	ret = circularBufferDrain_complete(&drain, third.id);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	circularBuffer_getCount(&buf, &res);
+	assert(res == 2);
+}
+
+void drain_writer_roundtrip(circularBufferDrainBackend_t backend) {
+	circularBuffer_t buf;
+	circularBufferDrain_t drain;
+	circularBufferDrainRecord_t records[4];
+	circularBufferDrainWriter_t writer;
+	uint8_t buf_storage[16];
+	uint8_t data[200];
+	uint8_t check[200];
+	char path[] = "/tmp/fk_cb_drainXXXXXX";
+	size_t i;
+	int fd;
+	int ret;
+
+	for (i = 0; i < sizeof(data); i++) {
+		data[i] = (uint8_t)(i * 7);
+	}
+	fd = mkstemp(path);
+	assert(fd >= 0);
+	unlink(path);
+
+	circularBuffer_init(&buf, buf_storage, sizeof(buf_storage), 1);
+	circularBufferDrain_init(&drain, &buf, records, 4);
+	ret = circularBufferDrainWriter_start(&writer, &drain, backend, fd, 10, 3);
+	if (CIRC_BUF_IO_ERROR == ret && CIRC_BUF_DRAIN_IO_URING == backend) {
+		/* io_uring disabled in this environment */
+		close(fd);
+		return;
+	}
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	/* the producer only ever waits for ring space, never for the file */
+	for (i = 0; i < sizeof(data); i += 5) {
+		while ((ret = circularBufferDrainWriter_push(&writer, &data[i], 5)) == CIRC_BUF_BUFFER_FULL) {
+			sched_yield();
+		}
+		assert(ret == CIRC_BUF_NO_ERROR);
+	}
+	ret = circularBufferDrainWriter_flush(&writer);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(circularBuffer_is_empty(&buf));
+	ret = circularBufferDrainWriter_stop(&writer);
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	assert(pread(fd, check, sizeof(check), 10) == (ssize_t)sizeof(check));
+	assert(memcmp(check, data, sizeof(data)) == 0);
+	close(fd);
+}
+
+void test_drain_writer() {
+	circularBuffer_t buf;
+	circularBufferDrain_t drain;
+	circularBufferDrainRecord_t records[17];
+	circularBufferDrainWriter_t writer;
+	uint8_t buf_storage[16];
+	uint8_t data[4] = {1, 2, 3, 4};
+	int fds[2];
+	int ret;
+
+	drain_writer_roundtrip(CIRC_BUF_DRAIN_PWRITEV);
+
+	circularBuffer_init(&buf, buf_storage, sizeof(buf_storage), 1);
+	circularBufferDrain_init(&drain, &buf, records, 17);
+	ret = circularBufferDrainWriter_start(&writer, &drain, CIRC_BUF_DRAIN_PWRITEV, 0, 0, 0);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+#ifdef FK_CB_DRAIN_IO_URING
+	ret = circularBufferDrainWriter_start(&writer, &drain, CIRC_BUF_DRAIN_IO_URING, 0, 0, 4);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	drain_writer_roundtrip(CIRC_BUF_DRAIN_IO_URING);
+#else
+	ret = circularBufferDrainWriter_start(&writer, &drain, CIRC_BUF_DRAIN_IO_URING, 0, 0, 4);
+	assert(ret == CIRC_BUF_FORMAT_ERROR);
+#endif
+
+	/* a pipe has no file offsets; the failure reaches the producer */
+	assert(pipe(fds) == 0);
+	circularBufferDrain_init(&drain, &buf, records, 2);
+	ret = circularBufferDrainWriter_start(&writer, &drain, CIRC_BUF_DRAIN_PWRITEV, fds[1], 0, 4);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferDrainWriter_push(&writer, data, 4);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferDrainWriter_flush(&writer);
+	assert(ret == CIRC_BUF_IO_ERROR);
+	ret = circularBufferDrainWriter_push(&writer, data, 4);
+	assert(ret == CIRC_BUF_IO_ERROR);
+	ret = circularBufferDrainWriter_stop(&writer);
+	assert(ret == CIRC_BUF_IO_ERROR);
+	assert(buf.count == 4);
+	close(fds[0]);
+	close(fds[1]);
+}
+
+typedef struct {
+	uint8_t data[64];
+	size_t pos;
+	size_t calls;
+} test_stream_t;
+
+int test_stream_write(void *p_context, const void *p_data, size_t size) {
+	test_stream_t *p_stream = p_context;
+	if (p_stream->pos + size > sizeof(p_stream->data)) return -1;
+	memcpy(p_stream->data + p_stream->pos, p_data, size);
+	p_stream->pos += size;
+	p_stream->calls++;
+	return 0;
+}
+
+int test_stream_read(void *p_context, void *p_data, size_t size) {
+	test_stream_t *p_stream = p_context;
+	if (p_stream->pos + size > sizeof(p_stream->data)) return -1;
+	memcpy(p_data, p_stream->data + p_stream->pos, size);
+	p_stream->pos += size;
+	p_stream->calls++;
+	return 0;
+}
+
+void test_serialize() {
+	circularBuffer_t src, dst;
+	char src_storage[8];
+	char dst_storage[6];
+	char data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	char output[6];
+	char desired_output[] = {4, 5, 6, 7, 0, 1};
+	test_stream_t stream;
+	int ret;
+
+	circularBuffer_init(&src, src_storage, sizeof(src_storage), 2);
+	circularBuffer_push_n(&src, data, 4, NULL);
+	circularBuffer_remove_records(&src, 2);
+	circularBuffer_push(&src, data, NULL);
+
+	memset(&stream, 0, sizeof(stream));
+	ret = circularBuffer_serialize(&src, test_stream_write, &stream, 2);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(stream.pos == CIRC_BUF_SERIAL_HEADER_SIZE + 6);
+	assert(stream.calls == 4);
+
+	/* restored into a smaller ring, unwrapped */
+	circularBuffer_init(&dst, dst_storage, sizeof(dst_storage), 2);
+	stream.pos = 0;
+	ret = circularBuffer_deserialize(&dst, test_stream_read, &stream, 0);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(dst.start == 0 && dst.count == 3 && dst.end == 0);
+	ret = circularBuffer_popFIFO_n(&dst, output, 3, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(memcmp(output, desired_output, sizeof(output)) == 0);
+
+	circularBuffer_init(&dst, dst_storage, sizeof(dst_storage), 3);
+	stream.pos = 0;
+	ret = circularBuffer_deserialize(&dst, test_stream_read, &stream, 0);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+
+	stream.data[0] = 'X';
+	stream.pos = 0;
+	ret = circularBuffer_deserialize(&dst, test_stream_read, &stream, 0);
+	assert(ret == CIRC_BUF_FORMAT_ERROR);
+
+	stream.pos = sizeof(stream.data) - 4;
+	ret = circularBuffer_deserialize(&dst, test_stream_read, &stream, 0);
+	assert(ret == CIRC_BUF_IO_ERROR);
+	ret = circularBuffer_serialize(&src, test_stream_write, &stream, 0);
+	assert(ret == CIRC_BUF_IO_ERROR);
+}
+
+void test_shm() {
+	circularBufferShm_t producer, consumer, local;
+	char name[64];
+	uint64_t region[64];
+	char data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	char output[8];
+	circularBufferSpan_t spans[2];
+	size_t span_count;
+	size_t res;
+	int ret;
+
+	snprintf(name, sizeof(name), "/fk_cb_test_%ld", (long)getpid());
+	ret = circularBufferShm_create(&producer, name, 2, 3);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_create(&consumer, name, 2, 3);
+	assert(ret == CIRC_BUF_IO_ERROR);
+	ret = circularBufferShm_attach(&consumer, name, 4);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferShm_attach(&consumer, name, 2);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(consumer.p_data != producer.p_data);
+	assert(consumer.buffer_slots == 3);
+
+	ret = circularBufferShm_push_n(&producer, data, 2, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_push_n(&producer, data + 4, 2, NULL);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+	circularBufferShm_getCount(&consumer, &res);
+	assert(res == 2);
+
+	ret = circularBufferShm_popFIFO_n(&consumer, output, 1, &res, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(res == 1 && output[0] == 0 && output[1] == 1);
+
+	/* wraps across the end of the shared slots */
+	ret = circularBufferShm_push_n(&producer, data + 4, 2, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_peek_spans(&consumer, 8, spans, &span_count);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(span_count == 2 && spans[0].size == 4 && spans[1].size == 2);
+	assert(spans[0].p_data[0] == 2 && spans[1].p_data[0] == 6);
+	ret = circularBufferShm_remove_records(&consumer, 10);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_popFIFO_n(&consumer, output, 1, NULL, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	assert(circularBufferShm_detach(&consumer) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferShm_detach(&producer) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferShm_unlink(name) == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_attach(&consumer, name, 2);
+	assert(ret == CIRC_BUF_IO_ERROR);
+
+	ret = circularBufferShm_format(&local, region, sizeof(region), 8);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferShm_open_region(&consumer, region, sizeof(region) / 2, 8);
+	assert(ret == CIRC_BUF_FORMAT_ERROR);
+	ret = circularBufferShm_open_region(&consumer, region, sizeof(region), 8);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(consumer.buffer_slots == (sizeof(region) - sizeof(circularBufferShmHeader_t)) / 8);
+	region[0] = 0;
+	ret = circularBufferShm_open_region(&consumer, region, sizeof(region), 8);
+	assert(ret == CIRC_BUF_FORMAT_ERROR);
+}
+
+typedef struct {
+	circularBufferSeq_t *p_seq;
+	atomic_bool done;
+} test_seq_owner_t;
+
+void *test_seq_owner(void *p_arg) {
+	test_seq_owner_t *p_owner = p_arg;
+	uint32_t value;
+
+	for (value = 0; value < 200000; value++) {
+		if (circularBuffer_is_full(&p_owner->p_seq->buffer)) {
+			circularBufferSeq_remove_records(p_owner->p_seq, 1);
+		}
+		circularBufferSeq_push(p_owner->p_seq, &value, NULL);
+	}
+	atomic_store(&p_owner->done, true);
+	return NULL;
+}
+
+void test_seqlock_snapshot() {
+	circularBufferSeq_t seq;
+	test_seq_owner_t owner;
+	circularBufferSeqSnapshot_t snapshot;
+	uint32_t storage[7];
+	uint32_t output[4];
+	uint32_t value;
+	pthread_t thread;
+	size_t i;
+	int ret;
+
+	ret = circularBufferSeq_init(&seq, storage, sizeof(storage), sizeof(uint32_t));
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferSeq_snapshot(&seq, output, 4, &snapshot, 1);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(snapshot.items == 0);
+
+	for (value = 0; value < 3; value++) {
+		circularBufferSeq_push(&seq, &value, NULL);
+	}
+	ret = circularBufferSeq_snapshot(&seq, output, 4, &snapshot, 1);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(snapshot.items == 3 && snapshot.count == 3 && snapshot.end == 3);
+	assert(output[0] == 0 && output[2] == 2);
+	circularBufferSeq_popFIFO(&seq, &value, NULL);
+	circularBufferSeq_popLIFO(&seq, &value, NULL);
+	circularBufferSeq_popFIFO_n(&seq, &value, 1, NULL);
+	circularBufferSeq_getCount(&seq, &i);
+	assert(i == 0);
+
+	/* every snapshot taken while the owner runs must be a run of consecutive values */
+	owner.p_seq = &seq;
+	atomic_init(&owner.done, false);
+	assert(pthread_create(&thread, NULL, test_seq_owner, &owner) == 0);
+	while (!atomic_load(&owner.done)) {
+		ret = circularBufferSeq_snapshot(&seq, output, 4, &snapshot, 0);
+		assert(ret == CIRC_BUF_NO_ERROR);
+		for (i = 1; i < snapshot.items; i++) {
+			assert(output[i] == output[i - 1] + 1);
+		}
+	}
+	pthread_join(thread, NULL);
+	ret = circularBufferSeq_snapshot(&seq, output, 4, &snapshot, 0);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(snapshot.items == 4 && output[3] == 199999);
+	circularBufferSeq_flush(&seq);
+}
+
+static uint64_t test_now;
+
+uint64_t test_clock(void) {
+	return test_now;
+}
+
+void test_latency() {
+	circularBufferLatency_t latency;
+	char storage[8];
+	uint64_t stamps[8];
+	char data[8] = {0};
+	uint64_t result;
+	int ret;
+	unsigned int i;
+
+	ret = circularBufferLatency_init(&latency, storage, sizeof(storage), 1, stamps, sizeof(stamps) - 1, test_clock);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferLatency_init(&latency, storage, sizeof(storage), 1, stamps, sizeof(stamps), test_clock);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferLatency_quantile(&latency, 0.5, &result);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	/* 100 items that each wait 10 ticks, then one that waits 1000 */
+	for (i = 0; i < 100; i++) {
+		test_now = i * 100;
+		circularBufferLatency_push(&latency, data, NULL);
+		test_now += 10;
+		ret = circularBufferLatency_popFIFO(&latency, data, NULL);
+		assert(ret == CIRC_BUF_NO_ERROR);
+	}
+	test_now = 100000;
+	circularBufferLatency_push_n(&latency, data, 3, NULL);
+	test_now += 1000;
+	circularBufferLatency_popFIFO_n(&latency, data, 1, NULL);
+	circularBufferLatency_remove_records(&latency, 5);
+	assert(latency.samples == 103);
+
+	circularBufferLatency_quantile(&latency, 0.5, &result);
+	assert(result == 10);
+	circularBufferLatency_quantile(&latency, 0.97, &result);
+	assert(result == 10);
+	circularBufferLatency_quantile(&latency, 0.99, &result);
+	assert(result >= 1000 && result < 1000 + 1000 / 16);
+	circularBufferLatency_quantile(&latency, 1, &result);
+	assert(result == 1000);
+	ret = circularBufferLatency_quantile(&latency, 1.5, &result);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+
+	circularBufferLatency_reset(&latency);
+	ret = circularBufferLatency_quantile(&latency, 0.5, &result);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	/* huge dwell times land in the last buckets without overflow */
+	test_now = 0;
+	circularBufferLatency_push(&latency, data, NULL);
+	test_now = UINT64_MAX;
+	circularBufferLatency_popFIFO(&latency, data, NULL);
+	circularBufferLatency_quantile(&latency, 0.5, &result);
+	assert(result == UINT64_MAX);
+
+	ret = circularBufferLatency_init(&latency, storage, sizeof(storage), 1, stamps, sizeof(stamps), NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(circularBufferLatency_clock_coarse() > 0);
+}
+
+#define TEST_WSDEQUE_ITEMS 100000
+
+typedef struct {
+	circularBufferWsDeque_t *p_deque;
+	atomic_bool done;
+	uint64_t sum;
+	size_t taken;
+} test_wsdeque_thief_t;
+
+void *test_wsdeque_thief(void *p_arg) {
+	test_wsdeque_thief_t *p_thief = p_arg;
+	uint32_t value;
+	int ret;
+
+	for (;;) {
+		ret = circularBufferWsDeque_steal(p_thief->p_deque, &value, NULL);
+		if (CIRC_BUF_NO_ERROR == ret) {
+			p_thief->sum += value;
+			p_thief->taken++;
+		} else if (CIRC_BUF_BUFFER_EMPTY == ret && atomic_load(&p_thief->done)) {
+			break;
+		}
+	}
+	return NULL;
+}
+
+void test_wsdeque() {
+	circularBufferWsDeque_t deque;
+	test_wsdeque_thief_t thieves[2];
+	pthread_t threads[2];
+	uint32_t storage[64];
+	uint32_t value;
+	uint32_t item;
+	uint64_t sum = 0;
+	size_t taken = 0;
+	size_t count;
+	int ret;
+	int i;
+
+	ret = circularBufferWsDeque_init(&deque, storage, sizeof(storage) - 1, sizeof(uint32_t));
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferWsDeque_init(&deque, storage, sizeof(storage), sizeof(uint32_t));
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferWsDeque_popLIFO(&deque, &value, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+	ret = circularBufferWsDeque_steal(&deque, &value, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	/* owner pops newest first, thieves take oldest first */
+	for (value = 0; value < 64; value++) {
+		assert(circularBufferWsDeque_push(&deque, &value, NULL) == CIRC_BUF_NO_ERROR);
+	}
+	ret = circularBufferWsDeque_push(&deque, &value, NULL);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+	circularBufferWsDeque_popLIFO(&deque, &value, NULL);
+	assert(value == 63);
+	circularBufferWsDeque_steal(&deque, &value, NULL);
+	assert(value == 0);
+	circularBufferWsDeque_getCount(&deque, &count);
+	assert(count == 62);
+	while (circularBufferWsDeque_popLIFO(&deque, &value, NULL) == CIRC_BUF_NO_ERROR) {
+	}
+	assert(value == 1);
+
+	/* every item is taken exactly once by the owner or a thief */
+	for (i = 0; i < 2; i++) {
+		thieves[i].p_deque = &deque;
+		thieves[i].sum = 0;
+		thieves[i].taken = 0;
+		atomic_init(&thieves[i].done, false);
+		assert(pthread_create(&threads[i], NULL, test_wsdeque_thief, &thieves[i]) == 0);
+	}
+	for (value = 1; value <= TEST_WSDEQUE_ITEMS; value++) {
+		while (circularBufferWsDeque_push(&deque, &value, NULL) == CIRC_BUF_BUFFER_FULL) {
+			if (circularBufferWsDeque_popLIFO(&deque, &item, NULL) == CIRC_BUF_NO_ERROR) {
+				sum += item;
+				taken++;
+			}
+		}
+		if (value % 3 == 0 && circularBufferWsDeque_popLIFO(&deque, &item, NULL) == CIRC_BUF_NO_ERROR) {
+			sum += item;
+			taken++;
+		}
+	}
+	for (i = 0; i < 2; i++) {
+		atomic_store(&thieves[i].done, true);
+	}
+	while (circularBufferWsDeque_popLIFO(&deque, &value, NULL) == CIRC_BUF_NO_ERROR) {
+		sum += value;
+		taken++;
+	}
+	for (i = 0; i < 2; i++) {
+		pthread_join(threads[i], NULL);
+		sum += thieves[i].sum;
+		taken += thieves[i].taken;
+	}
+	assert(taken == TEST_WSDEQUE_ITEMS);
+	assert(sum == (uint64_t)TEST_WSDEQUE_ITEMS * (TEST_WSDEQUE_ITEMS + 1) / 2);
+}
+
+#define TEST_MCAST_ITEMS 20000
+
+typedef struct {
+	circularBufferMcast_t *p_mcast;
+	size_t consumer;
+	uint32_t next;
+} test_mcast_reader_t;
+
+void *test_mcast_reader(void *p_arg) {
+	test_mcast_reader_t *p_reader = p_arg;
+	circularBufferSpan_t spans[2];
+	const uint32_t *p_item;
+	size_t span;
+	size_t i;
+
+	while (p_reader->next < TEST_MCAST_ITEMS) {
+		if (circularBufferMcast_peek_spans(p_reader->p_mcast, p_reader->consumer, 16, spans, NULL) != CIRC_BUF_NO_ERROR) {
+			sched_yield();
+			continue;
+		}
+		for (span = 0; span < 2; span++) {
+			p_item = (const uint32_t *)spans[span].p_data;
+			for (i = 0; i < spans[span].size / sizeof(uint32_t); i++) {
+				assert(p_item[i] == p_reader->next);
+				p_reader->next++;
+			}
+		}
+		circularBufferMcast_release(p_reader->p_mcast, p_reader->consumer, (spans[0].size + spans[1].size) / sizeof(uint32_t));
+	}
+	return NULL;
+}
+
+void test_multicast() {
+	circularBufferMcast_t mcast;
+	circularBufferMcastCursor_t cursors[3];
+	test_mcast_reader_t readers[2];
+	pthread_t threads[2];
+	circularBufferSpan_t spans[2];
+	uint32_t storage[8];
+	uint32_t data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+	uint32_t output[8];
+	size_t first;
+	size_t second;
+	size_t late;
+	size_t count;
+	size_t span_count;
+	uint32_t value;
+	int ret;
+	int i;
+
+	ret = circularBufferMcast_init(&mcast, storage, sizeof(storage), sizeof(uint32_t), cursors, sizeof(cursors[0]) - 1);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferMcast_init(&mcast, storage, sizeof(storage), sizeof(uint32_t), cursors, sizeof(cursors));
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	/* with nobody attached the producer never blocks */
+	for (i = 0; i < 3; i++) {
+		ret = circularBufferMcast_push_n(&mcast, data, 8, NULL);
+		assert(ret == CIRC_BUF_NO_ERROR);
+	}
+	circularBufferMcast_attach(&mcast, &first);
+	circularBufferMcast_attach(&mcast, &second);
+	circularBufferMcast_attach(&mcast, &late);
+	ret = circularBufferMcast_attach(&mcast, &count);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+	circularBufferMcast_detach(&mcast, late);
+	ret = circularBufferMcast_getCount(&mcast, late, &count);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferMcast_peek_spans(&mcast, first, 4, spans, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+
+	/* each consumer sees every item; the slowest one gates the producer */
+	circularBufferMcast_push_n(&mcast, data, 6, NULL);
+	circularBufferMcast_popFIFO_n(&mcast, first, output, 8, &count, NULL);
+	assert(count == 6 && output[5] == 5);
+	ret = circularBufferMcast_push_n(&mcast, data + 6, 4, NULL);
+	assert(ret == CIRC_BUF_SIZE_ERROR || ret == CIRC_BUF_BUFFER_FULL);
+	ret = circularBufferMcast_push_n(&mcast, data + 6, 2, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferMcast_push_n(&mcast, data, 1, NULL);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+	circularBufferMcast_getCount(&mcast, second, &count);
+	assert(count == 8);
+	circularBufferMcast_release(&mcast, second, 3);
+	ret = circularBufferMcast_push_n(&mcast, data, 3, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	/* the late consumer starts at the current end */
+	circularBufferMcast_attach(&mcast, &late);
+	circularBufferMcast_getCount(&mcast, late, &count);
+	assert(count == 0);
+	circularBufferMcast_peek_spans(&mcast, second, 8, spans, &span_count);
+	assert(span_count == 2 && spans[0].size == 5 * sizeof(uint32_t));
+	assert(((uint32_t *)spans[0].p_data)[0] == 3 && ((uint32_t *)spans[1].p_data)[2] == 2);
+	circularBufferMcast_detach(&mcast, second);
+	circularBufferMcast_popFIFO_n(&mcast, first, output, 8, &count, NULL);
+	assert(count == 5 && output[0] == 6 && output[4] == 2);
+	circularBufferMcast_detach(&mcast, first);
+	circularBufferMcast_detach(&mcast, late);
+
+	/* two concurrent readers each receive the whole stream in order */
+	for (i = 0; i < 2; i++) {
+		readers[i].p_mcast = &mcast;
+		readers[i].next = 0;
+		assert(circularBufferMcast_attach(&mcast, &readers[i].consumer) == CIRC_BUF_NO_ERROR);
+		assert(pthread_create(&threads[i], NULL, test_mcast_reader, &readers[i]) == 0);
+	}
+	for (value = 0; value < TEST_MCAST_ITEMS; value++) {
+		while (circularBufferMcast_push_n(&mcast, &value, 1, NULL) == CIRC_BUF_BUFFER_FULL) {
+			sched_yield();
+		}
+	}
+	for (i = 0; i < 2; i++) {
+		pthread_join(threads[i], NULL);
+		assert(readers[i].next == TEST_MCAST_ITEMS);
+	}
+}
+
+typedef struct {
+	unsigned int high;
+	unsigned int low;
+	size_t count;
+} test_watermark_log_t;
+
+void test_watermark_cb(void *p_context, const circularBuffer_t *p_buffer, unsigned int event) {
+	test_watermark_log_t *p_log = p_context;
+
+	p_log->count = p_buffer->count;
+	if (CIRC_BUF_WATERMARK_HIGH == event) {
+		p_log->high++;
+	} else {
+		p_log->low++;
+	}
+}
+
+void test_watermark() {
+	circularBuffer_t buffer;
+	circularBufferWatermark_t watermark = {3, 1, test_watermark_cb, NULL, 0};
+	test_watermark_log_t log = {0, 0, 0};
+	char storage[6];
+	char data[6] = {0};
+	int ret;
+
+	circularBuffer_init(&buffer, storage, sizeof(storage), 1);
+	watermark.p_context = &log;
+	watermark.low = 3;
+	ret = circularBuffer_set_watermark(&buffer, &watermark);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	watermark.low = 1;
+	watermark.high = 7;
+	ret = circularBuffer_set_watermark(&buffer, &watermark);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	watermark.high = 3;
+	watermark.events = CIRC_BUF_WATERMARK_LOW;
+	ret = circularBuffer_set_watermark(&buffer, &watermark);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(0 == watermark.events);
+
+	/* rising to the high mark fires once, staying above it does not */
+	circularBuffer_push(&buffer, data, NULL);
+	circularBuffer_push(&buffer, data, NULL);
+	assert(0 == log.high);
+	circularBuffer_push(&buffer, data, NULL);
+	assert(1 == log.high && 3 == log.count);
+	assert(CIRC_BUF_WATERMARK_HIGH == watermark.events);
+	circularBuffer_push_n(&buffer, data, 2, NULL);
+	circularBuffer_popFIFO(&buffer, data, NULL);
+	circularBuffer_popLIFO(&buffer, data, NULL);
+	assert(1 == log.high && 0 == log.low);
+
+	/* falling to the low mark fires once */
+	circularBuffer_popFIFO_n(&buffer, data, 2, NULL);
+	assert(1 == log.low && 1 == log.count);
+	circularBuffer_remove_records(&buffer, 1);
+	assert(1 == log.low);
+	watermark.events = 0;
+
+	/* a jump across both marks fires only the one in its direction */
+	circularBuffer_push_n(&buffer, data, 6, NULL);
+	assert(2 == log.high && CIRC_BUF_WATERMARK_HIGH == watermark.events);
+	circularBuffer_popLIFO_n(&buffer, data, 6, NULL);
+	assert(2 == log.low && 0 == log.count);
+	circularBuffer_push_n(&buffer, data, 4, NULL);
+	circularBuffer_remove_records(&buffer, 4);
+	assert(3 == log.high && 3 == log.low);
+
+	/* unregistered and flushed buffers stay quiet */
+	circularBuffer_push_n(&buffer, data, 4, NULL);
+	circularBuffer_flush(&buffer);
+	assert(4 == log.high && 3 == log.low);
+	circularBuffer_set_watermark(&buffer, NULL);
+	circularBuffer_push_n(&buffer, data, 4, NULL);
+	assert(4 == log.high);
+}
+
+typedef struct {
+	uint32_t value;
+	uint16_t key;
+	uint16_t pad;
+} test_reading_t;
+
+void test_coalesce() {
+	circularBufferCoalesce_t coalesce;
+	test_reading_t storage[8];
+	size_t index[16];
+	test_reading_t reading = {0, 0, 0};
+	test_reading_t out[8];
+	test_reading_t model[8];
+	size_t model_count = 0;
+	size_t i;
+	size_t n;
+	unsigned int step;
+	int ret;
+
+	ret = circularBufferCoalesce_init(&coalesce, storage, sizeof(storage), sizeof(test_reading_t), 4, 2, index, 8 * sizeof(size_t));
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferCoalesce_init(&coalesce, storage, sizeof(storage), sizeof(test_reading_t), 7, 2, index, sizeof(index));
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferCoalesce_init(&coalesce, storage, sizeof(storage), sizeof(test_reading_t), 4, 2, index, sizeof(index));
+	assert(ret == CIRC_BUF_NO_ERROR);
+
+	/* a newer reading replaces the queued one and keeps its place */
+	reading.key = 7;
+	reading.value = 1;
+	circularBufferCoalesce_push(&coalesce, &reading, NULL);
+	reading.key = 9;
+	circularBufferCoalesce_push(&coalesce, &reading, NULL);
+	reading.key = 7;
+	reading.value = 2;
+	circularBufferCoalesce_push(&coalesce, &reading, NULL);
+	assert(coalesce.buffer.count == 2);
+	reading.value = 0;
+	ret = circularBufferCoalesce_peek_key(&coalesce, &reading, out, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR && out[0].value == 2);
+	/* rejected pops leave the item and its key in place */
+	assert(circularBufferCoalesce_popFIFO(&coalesce, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferCoalesce_popFIFO_n(&coalesce, out, 0, NULL) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferCoalesce_peek_key(&coalesce, &reading, out, NULL) == CIRC_BUF_NO_ERROR);
+	circularBufferCoalesce_popFIFO(&coalesce, out, NULL);
+	assert(out[0].key == 7 && out[0].value == 2);
+	ret = circularBufferCoalesce_peek_key(&coalesce, &reading, out, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+	circularBufferCoalesce_flush(&coalesce);
+
+	/* compare against a plain array under a pseudo-random workload */
+	srand(36);
+	for (step = 0; step < 20000; step++) {
+		if (rand() % 3 != 0) {
+			reading.key = (uint16_t)(rand() % 12);
+			reading.value = step;
+			for (i = 0; i < model_count && model[i].key != reading.key; i++) {
+			}
+			ret = circularBufferCoalesce_push(&coalesce, &reading, NULL);
+			if (i < model_count) {
+				assert(ret == CIRC_BUF_NO_ERROR);
+				model[i] = reading;
+			} else if (model_count == 8) {
+				assert(ret == CIRC_BUF_BUFFER_FULL);
+			} else {
+				assert(ret == CIRC_BUF_NO_ERROR);
+				model[model_count++] = reading;
+			}
+		} else {
+			n = (size_t)(rand() % 3) + 1;
+			if (n > model_count) {
+				n = model_count;
+			}
+			if (0 == n) {
+				ret = circularBufferCoalesce_remove_records(&coalesce, 1);
+				assert(ret == CIRC_BUF_BUFFER_EMPTY);
+				continue;
+			}
+			if (rand() % 2) {
+				ret = circularBufferCoalesce_popFIFO_n(&coalesce, out, n, NULL);
+				assert(ret == CIRC_BUF_NO_ERROR);
+				for (i = 0; i < n; i++) {
+					assert(out[i].key == model[i].key && out[i].value == model[i].value);
+				}
+			} else {
+				ret = circularBufferCoalesce_remove_records(&coalesce, n);
+				assert(ret == CIRC_BUF_NO_ERROR);
+			}
+			memmove(model, model + n, (model_count - n) * sizeof(test_reading_t));
+			model_count -= n;
+		}
+		assert(coalesce.buffer.count == model_count);
+	}
+}
+
+void test_push_iov() {
+	circularBuffer_t buffer;
+	uint8_t storage[12];
+	uint8_t output[12];
+	uint8_t header[3] = {1, 2, 3};
+	uint8_t payload[5] = {4, 5, 6, 7, 8};
+	uint8_t first[4] = {9, 9, 9, 9};
+	circularBufferIovec_t iov[3];
+	circularBufferIovec_t parts[2];
+	int ret;
+
+	circularBuffer_init(&buffer, storage, sizeof(storage), 4);
+	iov[0].iov_base = header;
+	iov[0].iov_len = sizeof(header);
+	iov[1].iov_base = payload;
+	iov[1].iov_len = sizeof(payload);
+	iov[2].iov_base = payload;
+	iov[2].iov_len = 4;
+
+	ret = circularBuffer_push_iov(&buffer, iov, 0, NULL);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBuffer_push_iov(&buffer, iov, 1, NULL);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBuffer_push_iov(&buffer, iov, 3, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	assert(buffer.count == 3);
+	circularBuffer_remove_records(&buffer, 2);
+
+	/* the parts run across the wrap point; nothing is pushed when it will not fit */
+	ret = circularBuffer_push_iov(&buffer, iov, 3, NULL);
+	assert(ret == CIRC_BUF_BUFFER_FULL && buffer.count == 1);
+	ret = circularBuffer_push_iov(&buffer, iov, 2, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR && buffer.count == 3);
+	circularBuffer_popFIFO_n(&buffer, output, 3, NULL);
+	assert(output[3] == 7);
+	assert(output[4] == 1 && output[7] == 4 && output[8] == 5 && output[11] == 8);
+
+	parts[0].iov_base = first;
+	parts[0].iov_len = sizeof(first);
+	parts[1].iov_base = output;
+	parts[1].iov_len = 8;
+	ret = circularBuffer_push_iov(&buffer, parts, 2, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	parts[1].iov_len = SIZE_MAX;
+	ret = circularBuffer_push_iov(&buffer, parts, 2, NULL);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+}
+
+void test_compact() {
+	uint64_t region16[(sizeof(circularBufferCompact16_t) + 5 * 4) / sizeof(uint64_t) + 1];
+	uint64_t region32[(sizeof(circularBufferCompact32_t) + 3 * 8) / sizeof(uint64_t)];
+	circularBufferCompact16_t *p_small = (circularBufferCompact16_t *)region16;
+	circularBufferCompact32_t *p_large = (circularBufferCompact32_t *)region32;
+	uint32_t data[5] = {1, 2, 3, 4, 5};
+	uint32_t output[5];
+	uint64_t wide[3] = {10, 20, 30};
+	uint64_t wide_out[3];
+	size_t count;
+	int ret;
+
+	assert(sizeof(circularBufferCompact16_t) == 8);
+	assert(sizeof(circularBufferCompact32_t) == 16);
+	ret = circularBufferCompact16_init(p_small, 4, 4);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferCompact16_init(p_small, CIRC_BUF_COMPACT16_REGION_SIZE(70000, 1), 70000);
+	assert(ret == CIRC_BUF_SIZE_ERROR);
+	ret = circularBufferCompact16_init(p_small, CIRC_BUF_COMPACT16_REGION_SIZE(4, 5), 4);
+	assert(ret == CIRC_BUF_NO_ERROR && p_small->buffer_slots == 5);
+
+	circularBufferCompact16_push_n(p_small, data, 4, NULL);
+	circularBufferCompact16_popFIFO_n(p_small, output, 3, NULL);
+	assert(output[2] == 3);
+	/* wraps around the end of the inline storage */
+	ret = circularBufferCompact16_push_n(p_small, data, 4, NULL);
+	assert(ret == CIRC_BUF_NO_ERROR);
+	ret = circularBufferCompact16_push(p_small, data, NULL);
+	assert(ret == CIRC_BUF_BUFFER_FULL);
+	circularBufferCompact16_peek(p_small, output, 5, NULL);
+	assert(output[0] == 4 && output[1] == 1 && output[4] == 4);
+	circularBufferCompact16_popLIFO(p_small, output, NULL);
+	assert(output[0] == 4);
+	circularBufferCompact16_popLIFO_n(p_small, output, 2, NULL);
+	assert(output[0] == 2 && output[1] == 3);
+	circularBufferCompact16_popFIFO(p_small, output, NULL);
+	assert(output[0] == 4);
+	circularBufferCompact16_getCount(p_small, &count);
+	assert(count == 1);
+	circularBufferCompact16_remove_records(p_small, 1);
+	ret = circularBufferCompact16_popFIFO(p_small, output, NULL);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+	circularBufferCompact16_push(p_small, data, NULL);
+	circularBufferCompact16_flush(p_small);
+	assert(p_small->count == 0 && p_small->start == 0);
+
+	ret = circularBufferCompact32_init(p_large, sizeof(region32), sizeof(uint64_t));
+	assert(ret == CIRC_BUF_NO_ERROR && p_large->buffer_slots == 3);
+	circularBufferCompact32_push(p_large, &wide[0], NULL);
+	circularBufferCompact32_push_n(p_large, &wide[1], 2, NULL);
+	circularBufferCompact32_popFIFO(p_large, wide_out, NULL);
+	circularBufferCompact32_push(p_large, &wide[0], NULL);
+	circularBufferCompact32_peek(p_large, wide_out, 3, NULL);
+	assert(wide_out[0] == 20 && wide_out[2] == 10);
+	circularBufferCompact32_popLIFO(p_large, wide_out, NULL);
+	assert(wide_out[0] == 10);
+	circularBufferCompact32_popLIFO_n(p_large, wide_out, 1, NULL);
+	circularBufferCompact32_popFIFO_n(p_large, wide_out, 2, NULL);
+	assert(wide_out[0] == 20);
+	circularBufferCompact32_getCount(p_large, &count);
+	assert(count == 0);
+	ret = circularBufferCompact32_remove_records(p_large, 1);
+	assert(ret == CIRC_BUF_BUFFER_EMPTY);
+	circularBufferCompact32_flush(p_large);
+}
+
+void test_stream_memcpy() {
+	circularBuffer_t src;
+	circularBuffer_t dst;
+	size_t size = 1024 * 1024 + 100;
+	uint8_t *p_src = malloc(size);
+	uint8_t *p_dst = malloc(size + 1);
+	uint8_t *p_batch = malloc(size);
+	size_t sizes[] = {0, 1, 31, 64, 127, 129, 4099};
+	size_t i;
+	size_t j;
+
+	assert(p_src != NULL && p_dst != NULL && p_batch != NULL);
+	for (i = 0; i < size; i++) {
+		p_src[i] = (uint8_t)(i * 7 + 3);
+	}
+	assert(circularBufferStream_level() <= CIRC_BUF_STREAM_AVX);
+
+	/* every size and misalignment goes through the streaming path */
+	circularBufferStream_set_threshold(0);
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		for (j = 0; j < 3; j++) {
+			memset(p_dst, 0, sizes[i] + 1);
+			assert(circularBufferStream_memcpy(p_dst + j, p_src + i, sizes[i]) == p_dst + j);
+			assert(0 == memcmp(p_dst + j, p_src + i, sizes[i]));
+		}
+	}
+	circularBufferStream_set_threshold(CIRC_BUF_STREAM_THRESHOLD);
+
+	/* a wrapped multi-megabyte batch through the core */
+	circularBuffer_init(&src, p_src, size - 100, 64);
+	circularBuffer_init(&dst, p_dst, size - 100, 64);
+	src.count = src.buffer_slots;
+	src.start = 5;
+	src.end = 5;
+	assert(circularBuffer_copy(&dst, &src, circularBufferStream_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(circularBuffer_popFIFO_n(&dst, p_batch, dst.buffer_slots, circularBufferStream_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(0 == memcmp(p_batch, p_src + 5 * 64, (src.buffer_slots - 5) * 64));
+	assert(0 == memcmp(p_batch + (src.buffer_slots - 5) * 64, p_src, 5 * 64));
+
+	free(p_src);
+	free(p_dst);
+	free(p_batch);
+}
+
+void test_parallel_copy() {
+	circularBufferPool_t pool;
+	pthread_t threads[2];
+	circularBuffer_t src;
+	circularBuffer_t dst;
+	uint32_t src_data[1000];
+	uint32_t dst_data[1000];
+	uint32_t input[1000];
+	uint32_t output[1000];
+	size_t count;
+	size_t i;
+
+	for (i = 0; i < 1000; i++) {
+		input[i] = (uint32_t)i;
+	}
+
+	assert(circularBufferPool_init(&pool, NULL, 2, 64, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferPool_init(&pool, threads, 2, 64, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_poll(&pool) == CIRC_BUF_NO_ERROR);
+
+	/* a wrapping push_n is committed only once the copy completes */
+	circularBuffer_init(&src, src_data, sizeof(src_data), sizeof(uint32_t));
+	src.start = src.end = 900;
+	assert(circularBufferPool_push_n(&pool, &src, input, 1001) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferPool_push_n(&pool, &src, input, 300) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_push_n(&pool, &src, input, 1) == CIRC_BUF_RETRY_ERROR);
+	assert(circularBufferPool_wait(&pool) == CIRC_BUF_NO_ERROR);
+	circularBuffer_getCount(&src, &count);
+	assert(300 == count);
+	assert(circularBufferPool_push_n(&pool, &src, input, 701) == CIRC_BUF_BUFFER_FULL);
+
+	assert(circularBufferPool_peek(&pool, &src, output, 301) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferPool_peek(&pool, &src, output, 300) == CIRC_BUF_NO_ERROR);
+	while (circularBufferPool_poll(&pool) == CIRC_BUF_RETRY_ERROR) {
+		sched_yield();
+	}
+	assert(0 == memcmp(output, input, 300 * sizeof(uint32_t)));
+
+	/* a rejected copy gives the pool back */
+	circularBuffer_init(&dst, dst_data, sizeof(dst_data) / 2, sizeof(uint32_t));
+	assert(circularBufferPool_copy(&pool, &dst, &src) == CIRC_BUF_SIZE_ERROR);
+
+	/* snapshot of the whole ring */
+	circularBuffer_init(&dst, dst_data, sizeof(dst_data), sizeof(uint32_t));
+	assert(circularBufferPool_copy(&pool, &dst, &src) == CIRC_BUF_NO_ERROR);
+	assert(dst.start == src.start && dst.count == src.count);
+	assert(circularBufferPool_wait(&pool) == CIRC_BUF_NO_ERROR);
+
+	memset(output, 0, sizeof(output));
+	assert(circularBufferPool_popFIFO_n(&pool, &dst, output, 1000) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_wait(&pool) == CIRC_BUF_NO_ERROR);
+	assert(0 == memcmp(output, input, 300 * sizeof(uint32_t)));
+	circularBuffer_getCount(&dst, &count);
+	assert(0 == count);
+	assert(circularBufferPool_popFIFO_n(&pool, &dst, output, 1) == CIRC_BUF_BUFFER_EMPTY);
+
+	assert(circularBufferPool_memcpy(&pool, output, input, 0) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferPool_memcpy(&pool, output, input, 999) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_destroy(&pool) == CIRC_BUF_NO_ERROR);
+	assert(0 == memcmp(output, input, 999));
+
+	/* without workers the waiting thread does all of the copying */
+	assert(circularBufferPool_init(&pool, NULL, 0, 0, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_memcpy(&pool, dst_data, src_data, sizeof(src_data)) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferPool_poll(&pool) == CIRC_BUF_RETRY_ERROR);
+	assert(circularBufferPool_wait(&pool) == CIRC_BUF_NO_ERROR);
+	assert(0 == memcmp(dst_data, src_data, sizeof(src_data)));
+	assert(circularBufferPool_destroy(&pool) == CIRC_BUF_NO_ERROR);
+}
+
+void test_item_sizes() {
+	circularBuffer_t buffer;
+	uint8_t storage[4 * 64];
+	uint8_t input[64];
+	uint8_t output[64];
+	size_t sizes[] = {1, 2, 3, 4, 8, 16, 64};
+	size_t i;
+	size_t j;
+
+	for (i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+		assert(circularBuffer_init(&buffer, storage, 4 * sizes[i], sizes[i]) == CIRC_BUF_NO_ERROR);
+		/* wrap around the end of the storage */
+		for (j = 0; j < 6; j++) {
+			memset(input, (int)j, sizes[i]);
+			assert(circularBuffer_push(&buffer, input, NULL) == CIRC_BUF_NO_ERROR);
+			assert(circularBuffer_popFIFO(&buffer, output, NULL) == CIRC_BUF_NO_ERROR);
+			assert(0 == memcmp(input, output, sizes[i]));
+		}
+		for (j = 0; j < 4; j++) {
+			memset(input, (int)(j + 10), sizes[i]);
+			assert(circularBuffer_push(&buffer, input, NULL) == CIRC_BUF_NO_ERROR);
+		}
+		assert(circularBuffer_push(&buffer, input, NULL) == CIRC_BUF_BUFFER_FULL);
+		assert(circularBuffer_popLIFO(&buffer, output, NULL) == CIRC_BUF_NO_ERROR);
+		assert(0 == memcmp(input, output, sizes[i]));
+		assert(circularBuffer_popFIFO(&buffer, output, memcpy) == CIRC_BUF_NO_ERROR);
+		memset(input, 10, sizes[i]);
+		assert(0 == memcmp(input, output, sizes[i]));
+		assert(circularBuffer_popLIFO(&buffer, output, memcpy) == CIRC_BUF_NO_ERROR);
+		memset(input, 12, sizes[i]);
+		assert(0 == memcmp(input, output, sizes[i]));
+	}
+}
+
+void test_storage_alloc() {
+	circularBufferStorage_t storage;
+	circularBuffer_t buffer;
+	uint64_t value;
+	uint64_t i;
+	unsigned int flags[] = {
+		0,
+		CIRC_BUF_STORAGE_THP | CIRC_BUF_STORAGE_PREFAULT,
+		CIRC_BUF_STORAGE_HUGETLB | CIRC_BUF_STORAGE_PREFAULT,
+	};
+	size_t f;
+
+	assert(circularBufferStorage_alloc(NULL, 4096, CIRC_BUF_STORAGE_ANY_NODE, 0) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferStorage_alloc(&storage, 0, CIRC_BUF_STORAGE_ANY_NODE, 0) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferStorage_alloc(&storage, 4096, CIRC_BUF_STORAGE_MAX_NODES, 0) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferStorage_alloc(&storage, 4096, -2, 0) == CIRC_BUF_SIZE_ERROR);
+
+	for (f = 0; f < sizeof(flags) / sizeof(flags[0]); f++) {
+		assert(circularBufferStorage_alloc(&storage, 100000 * sizeof(uint64_t), CIRC_BUF_STORAGE_ANY_NODE, flags[f]) == CIRC_BUF_NO_ERROR);
+		assert(storage.mapped_size >= storage.size);
+		/* huge pages are a hint, falling back to transparent ones; prefaulting is not */
+		assert(flags[f] != 0 || 0 == storage.flags);
+		assert((storage.flags & CIRC_BUF_STORAGE_PREFAULT) == (flags[f] & CIRC_BUF_STORAGE_PREFAULT));
+
+		assert(circularBuffer_init(&buffer, storage.p_data, storage.size, sizeof(uint64_t)) == CIRC_BUF_NO_ERROR);
+		for (i = 0; i < 100000; i++) {
+			assert(circularBuffer_push(&buffer, &i, NULL) == CIRC_BUF_NO_ERROR);
+		}
+		for (i = 0; i < 100000; i++) {
+			assert(circularBuffer_popFIFO(&buffer, &value, NULL) == CIRC_BUF_NO_ERROR);
+			assert(value == i);
+		}
+		assert(circularBufferStorage_free(&storage) == CIRC_BUF_NO_ERROR);
+		assert(NULL == storage.p_data);
+	}
+	assert(circularBufferStorage_free(&storage) == CIRC_BUF_ADDR_ERROR);
+}
+
+void test_storage_trim() {
+	circularBufferStorage_t storage;
+	circularBuffer_t buffer;
+	circularBufferWatermark_t watermark;
+	circularBufferTrim_t trim;
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t slots = 16 * page / sizeof(uint64_t);
+	size_t released;
+	uint64_t value;
+	uint64_t i;
+
+	assert(circularBufferStorage_trim(NULL, NULL, 0, false, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferStorage_alloc(&storage, slots * sizeof(uint64_t), CIRC_BUF_STORAGE_ANY_NODE, 0) == CIRC_BUF_NO_ERROR);
+	circularBuffer_init(&buffer, storage.p_data, slots * sizeof(uint64_t), sizeof(uint64_t));
+
+	/* full: nothing to release */
+	for (i = 0; i < slots; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	assert(circularBufferStorage_trim(&buffer, &storage, 0, false, &released) == CIRC_BUF_NO_ERROR);
+	assert(0 == released);
+
+	/* free region of 10 pages minus one item: only 9 whole pages go */
+	circularBuffer_remove_records(&buffer, 10 * page / sizeof(uint64_t) - 1);
+	assert(circularBufferStorage_trim(&buffer, NULL, 10 * page, false, &released) == CIRC_BUF_NO_ERROR);
+	assert(0 == released);
+	assert(circularBufferStorage_trim(&buffer, &storage, 0, false, &released) == CIRC_BUF_NO_ERROR);
+	assert(9 * page == released);
+	assert(0 == ((uint64_t *)storage.p_data)[0]);
+	for (i = 10 * page / sizeof(uint64_t) - 1; i < slots; i++) {
+		assert(circularBuffer_popFIFO(&buffer, &value, NULL) == CIRC_BUF_NO_ERROR);
+		assert(value == i);
+	}
+
+	/* wrapped free region, trimmed from the low watermark */
+	for (i = 0; i < slots / 2; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	memset(&trim, 0, sizeof(trim));
+	trim.p_storage = &storage;
+	trim.lazy = true;
+	watermark.high = slots / 2;
+	watermark.low = 1;
+	watermark.fp_callback = circularBufferStorage_trim_on_low;
+	watermark.p_context = &trim;
+	assert(circularBuffer_set_watermark(&buffer, &watermark) == CIRC_BUF_NO_ERROR);
+	circularBuffer_remove_records(&buffer, slots / 2 - 2);
+	assert(0 == trim.released);
+	assert(circularBuffer_popFIFO(&buffer, &value, NULL) == CIRC_BUF_NO_ERROR);
+	assert(CIRC_BUF_NO_ERROR == trim.result);
+	assert(15 * page == trim.released);
+	assert(circularBuffer_popFIFO(&buffer, &value, NULL) == CIRC_BUF_NO_ERROR);
+	assert(slots / 2 - 1 == value);
+
+	assert(circularBufferStorage_free(&storage) == CIRC_BUF_NO_ERROR);
+}
+
+void test_storage_trim_huge() {
+	circularBufferStorage_t storage;
+	circularBufferStorage_t huge;
+	circularBuffer_t buffer;
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	size_t huge_page = 2 * 1024 * 1024;
+	size_t released;
+
+	/* explicit huge pages, when the system has any reserved */
+	assert(circularBufferStorage_alloc(&storage, 2 * huge_page, CIRC_BUF_STORAGE_ANY_NODE, CIRC_BUF_STORAGE_HUGETLB) == CIRC_BUF_NO_ERROR);
+	assert(storage.page_size >= page);
+	assert(0 == (uintptr_t)storage.p_data % storage.page_size);
+	circularBuffer_init(&buffer, storage.p_data, storage.mapped_size, 1);
+	circularBuffer_add_records(&buffer, storage.page_size / 2);
+	if (storage.flags & CIRC_BUF_STORAGE_HUGETLB) {
+		assert(circularBufferStorage_trim(&buffer, &storage, 0, true, &released) == CIRC_BUF_NO_ERROR);
+		assert(storage.mapped_size - storage.page_size == released);
+	}
+	assert(circularBufferStorage_free(&storage) == CIRC_BUF_NO_ERROR);
+
+	/* huge page rounding and no lazy release, checked on normal pages */
+	assert(circularBufferStorage_alloc(&storage, 2 * huge_page, CIRC_BUF_STORAGE_ANY_NODE, CIRC_BUF_STORAGE_THP) == CIRC_BUF_NO_ERROR);
+	assert(page == storage.page_size);
+	memset(storage.p_data, 0xff, storage.mapped_size);
+	huge = storage;
+	huge.flags |= CIRC_BUF_STORAGE_HUGETLB;
+	huge.page_size = huge_page;
+	circularBuffer_init(&buffer, storage.p_data, 2 * huge_page, 1);
+	circularBuffer_add_records(&buffer, huge_page / 2);
+	assert(circularBufferStorage_trim(&buffer, &huge, 0, true, &released) == CIRC_BUF_NO_ERROR);
+	assert(huge_page == released);
+	assert(0xff == ((uint8_t *)storage.p_data)[huge_page - 1]);
+	assert(0 == ((uint8_t *)storage.p_data)[huge_page]);
+	assert(0 == ((uint8_t *)storage.p_data)[2 * huge_page - 1]);
+	huge.page_size = 0;
+	assert(circularBufferStorage_trim(&buffer, &huge, 0, true, &released) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferStorage_free(&storage) == CIRC_BUF_NO_ERROR);
+}
+
+void test_read_txn() {
+	circularBuffer_t buffer;
+	uint8_t storage[8];
+	circularBufferReadTxn_t txn = CIRC_BUF_READ_TXN_INIT;
+	circularBufferSpan_t spans[2];
+	size_t span_count;
+	size_t count;
+
+	circularBuffer_init(&buffer, storage, sizeof(storage), 1);
+	assert(circularBuffer_read_next(&buffer, NULL, 1, spans, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_read_mark(NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_read_rollback(NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_read_commit(&buffer, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_BUFFER_EMPTY);
+
+	/* a length-prefixed frame that wraps and arrives in two pieces */
+	buffer.start = buffer.end = 6;
+	circularBuffer_push_n(&buffer, "\x03" "ab", 3, NULL);
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_NO_ERROR);
+	assert(3 == spans[0].p_data[0]);
+	assert(circularBuffer_read_next(&buffer, &txn, 3, spans, &span_count) == CIRC_BUF_NO_ERROR);
+	assert(2 == span_count && 1 == spans[0].size && 1 == spans[1].size);
+	assert('a' == spans[0].p_data[0] && 'b' == spans[1].p_data[0]);
+	assert(circularBuffer_read_rollback(&txn) == CIRC_BUF_NO_ERROR);
+	assert(0 == txn.cursor);
+
+	/* more input arrives; nothing was consumed or copied */
+	circularBuffer_push_n(&buffer, "c" "\x01" "d", 3, NULL);
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBuffer_read_next(&buffer, &txn, 3, spans, NULL) == CIRC_BUF_NO_ERROR);
+	assert(3 == spans[0].size + spans[1].size);
+	assert(circularBuffer_read_mark(&txn) == CIRC_BUF_NO_ERROR);
+	/* start on the next frame, then commit only the first */
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_NO_ERROR);
+	assert(1 == spans[0].p_data[0]);
+	assert(circularBuffer_read_commit(&buffer, &txn) == CIRC_BUF_NO_ERROR);
+	circularBuffer_getCount(&buffer, &count);
+	assert(2 == count);
+	assert(1 == txn.cursor && 0 == txn.mark);
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_NO_ERROR);
+	assert('d' == spans[0].p_data[0]);
+	assert(circularBuffer_read_next(&buffer, &txn, 1, spans, NULL) == CIRC_BUF_BUFFER_EMPTY);
+
+	/* another removal invalidates the transaction */
+	circularBuffer_remove_records(&buffer, 1);
+	assert(circularBuffer_read_commit(&buffer, &txn) == CIRC_BUF_SIZE_ERROR);
+}
+
+void test_find_byte() {
+	circularBuffer_t buffer;
+	uint32_t words[4];
+	uint8_t storage[8];
+	char line[8];
+	size_t index;
+	size_t popped;
+
+	circularBuffer_init(&buffer, words, sizeof(words), sizeof(uint32_t));
+	assert(circularBuffer_find_byte(&buffer, 0, '\n', &index) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBuffer_pop_until(&buffer, '\n', line, sizeof(line), NULL, NULL) == CIRC_BUF_SIZE_ERROR);
+
+	circularBuffer_init(&buffer, storage, sizeof(storage), 1);
+	assert(circularBuffer_find_byte(NULL, 0, '\n', &index) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_find_byte(&buffer, 0, '\n', NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_find_byte(&buffer, 0, '\n', &index) == CIRC_BUF_NOT_FOUND);
+	assert(circularBuffer_pop_until(&buffer, '\n', line, sizeof(line), &popped, NULL) == CIRC_BUF_NOT_FOUND);
+	assert(circularBuffer_pop_until(&buffer, '\n', line, 0, &popped, NULL) == CIRC_BUF_SIZE_ERROR);
+
+	/* "ab\ncd\nef" with the second line wrapping */
+	buffer.start = buffer.end = 4;
+	circularBuffer_push_n(&buffer, "ab\ncd\nef", 8, NULL);
+	assert(circularBuffer_find_byte(&buffer, 0, '\n', &index) == CIRC_BUF_NO_ERROR);
+	assert(2 == index);
+	assert(circularBuffer_find_byte(&buffer, 3, '\n', &index) == CIRC_BUF_NO_ERROR);
+	assert(5 == index);
+	assert(circularBuffer_find_byte(&buffer, 6, '\n', &index) == CIRC_BUF_NOT_FOUND);
+	assert(circularBuffer_find_byte(&buffer, 8, '\n', &index) == CIRC_BUF_NOT_FOUND);
+	assert(circularBuffer_find_byte(&buffer, 0, 'f', &index) == CIRC_BUF_NO_ERROR);
+	assert(7 == index);
+
+	/* too long for the destination: nothing is removed */
+	assert(circularBuffer_pop_until(&buffer, '\n', line, 2, &popped, NULL) == CIRC_BUF_SIZE_ERROR);
+	assert(0 == popped);
+	assert(circularBuffer_pop_until(&buffer, '\n', line, 3, &popped, NULL) == CIRC_BUF_NO_ERROR);
+	assert(3 == popped && 0 == memcmp(line, "ab\n", 3));
+	assert(circularBuffer_pop_until(&buffer, '\n', line, sizeof(line), &popped, NULL) == CIRC_BUF_NO_ERROR);
+	assert(3 == popped && 0 == memcmp(line, "cd\n", 3));
+	assert(circularBuffer_pop_until(&buffer, '\n', line, sizeof(line), &popped, NULL) == CIRC_BUF_NOT_FOUND);
+	assert(0 == popped);
+	assert(circularBuffer_pop_until(&buffer, 'f', line, sizeof(line), &popped, NULL) == CIRC_BUF_NO_ERROR);
+	assert(2 == popped && 0 == memcmp(line, "ef", 2));
+}
+
+bool test_filter_keep(void *p_context, const void *p_item) {
+	uint16_t value;
+
+	memcpy(&value, p_item, sizeof(value));
+	return value % *(uint16_t *)p_context != 0;
+}
+
+void test_filter() {
+	circularBuffer_t buffer;
+	uint16_t storage[8];
+	uint16_t output[8];
+	uint16_t divisor = 3;
+	uint16_t i;
+	size_t removed;
+	size_t count;
+
+	circularBuffer_init(&buffer, storage, sizeof(storage), sizeof(uint16_t));
+	assert(circularBuffer_filter(NULL, test_filter_keep, &divisor, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_filter(&buffer, NULL, &divisor, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_filter(&buffer, test_filter_keep, &divisor, &removed, NULL) == CIRC_BUF_BUFFER_EMPTY);
+
+	/* 1..8 stored across the wrap point; drop the multiples of 3 */
+	buffer.start = buffer.end = 5;
+	for (i = 1; i <= 8; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	assert(circularBuffer_filter(&buffer, test_filter_keep, &divisor, &removed, NULL) == CIRC_BUF_NO_ERROR);
+	assert(2 == removed);
+	circularBuffer_getCount(&buffer, &count);
+	assert(6 == count);
+	assert(3 == buffer.end);
+
+	/* the freed slots are usable again and order is kept */
+	i = 9;
+	assert(circularBuffer_push(&buffer, &i, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBuffer_popFIFO_n(&buffer, output, 8, NULL) == CIRC_BUF_NO_ERROR);
+	assert(1 == output[0] && 2 == output[1] && 4 == output[2] && 5 == output[3]);
+	assert(7 == output[4] && 8 == output[5] && 9 == output[6]);
+
+	/* keeping everything copies nothing; dropping everything empties */
+	i = 1;
+	circularBuffer_push(&buffer, &i, NULL);
+	divisor = 2;
+	assert(circularBuffer_filter(&buffer, test_filter_keep, &divisor, &removed, NULL) == CIRC_BUF_NO_ERROR);
+	assert(0 == removed);
+	divisor = 1;
+	assert(circularBuffer_filter(&buffer, test_filter_keep, &divisor, &removed, memcpy) == CIRC_BUF_NO_ERROR);
+	assert(1 == removed);
+	assert(circularBuffer_is_empty(&buffer));
+}
+
+size_t test_sync_bytes;
+
+void *test_sync_memcpy(void * FK_CB_KW_RESTRICT dst, const void * FK_CB_KW_RESTRICT src, size_t num) {
+	test_sync_bytes += num;
+	return memcpy(dst, src, num);
+}
+
+void test_sync() {
+	circularBuffer_t src;
+	circularBuffer_t dst;
+	circularBuffer_t other;
+	uint32_t src_data[16];
+	uint32_t dst_data[16];
+	uint32_t other_data[16];
+	uint32_t output[16];
+	uint32_t i;
+
+	circularBuffer_init(&src, src_data, sizeof(src_data), sizeof(uint32_t));
+	circularBuffer_init(&dst, dst_data, sizeof(dst_data) / 2, sizeof(uint32_t));
+	assert(circularBuffer_sync(NULL, &src, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_sync(&dst, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_sync(&dst, &src, NULL) == CIRC_BUF_SIZE_ERROR);
+
+	/* first sync is a full copy */
+	circularBuffer_init(&dst, dst_data, sizeof(dst_data), sizeof(uint32_t));
+	for (i = 0; i < 10; i++) {
+		circularBuffer_push(&src, &i, NULL);
+	}
+	dst.write_seq = 100;
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(sizeof(src_data) == test_sync_bytes);
+
+	/* then only the newly written slots, across the wrap point */
+	circularBuffer_remove_records(&src, 8);
+	for (i = 10; i < 20; i++) {
+		circularBuffer_push(&src, &i, NULL);
+	}
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(10 * sizeof(uint32_t) == test_sync_bytes);
+	assert(dst.start == src.start && dst.end == src.end && dst.count == src.count);
+	assert(circularBuffer_peek(&dst, output, 12, NULL) == CIRC_BUF_NO_ERROR);
+	for (i = 0; i < 12; i++) {
+		assert(i + 8 == output[i]);
+	}
+
+	/* a popped tail item is replaced; nothing else changes */
+	circularBuffer_popLIFO(&src, &i, NULL);
+	i = 99;
+	circularBuffer_push(&src, &i, NULL);
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(sizeof(uint32_t) == test_sync_bytes);
+	assert(circularBuffer_popLIFO(&dst, &i, NULL) == CIRC_BUF_NO_ERROR);
+	assert(99 == i);
+
+	/* pops from the replica only move its indices, which the next sync restores */
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(0 == test_sync_bytes);
+	assert(dst.count == src.count);
+
+	/* copying into the source makes the next sync a full copy */
+	circularBuffer_init(&src, src_data, sizeof(src_data), sizeof(uint32_t));
+	circularBuffer_init(&dst, dst_data, sizeof(dst_data), sizeof(uint32_t));
+	circularBuffer_init(&other, other_data, sizeof(other_data), sizeof(uint32_t));
+	for (i = 0; i < 4; i++) {
+		circularBuffer_push(&src, &i, NULL);
+	}
+	assert(circularBuffer_sync(&dst, &src, NULL) == CIRC_BUF_NO_ERROR);
+	for (i = 100; i < 105; i++) {
+		circularBuffer_push(&other, &i, NULL);
+	}
+	assert(circularBuffer_copy(&src, &other, NULL) == CIRC_BUF_NO_ERROR);
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(sizeof(src_data) == test_sync_bytes);
+	assert(circularBuffer_peek(&dst, output, 5, NULL) == CIRC_BUF_NO_ERROR);
+	for (i = 0; i < 5; i++) {
+		assert(i + 100 == output[i]);
+	}
+
+	/* a replica made by circularBuffer_copy is fully copied once, then kept by sync */
+	assert(circularBuffer_copy(&dst, &src, NULL) == CIRC_BUF_NO_ERROR);
+	i = 105;
+	circularBuffer_push(&src, &i, NULL);
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(sizeof(src_data) == test_sync_bytes);
+	assert(dst.write_seq == src.write_seq);
+	i = 106;
+	circularBuffer_push(&src, &i, NULL);
+	test_sync_bytes = 0;
+	assert(circularBuffer_sync(&dst, &src, test_sync_memcpy) == CIRC_BUF_NO_ERROR);
+	assert(sizeof(uint32_t) == test_sync_bytes);
+	assert(circularBuffer_peek(&dst, output, 7, NULL) == CIRC_BUF_NO_ERROR);
+	for (i = 0; i < 7; i++) {
+		assert(i + 100 == output[i]);
+	}
+}
+
+int test_transform_fail(void *p_context, void *p_dst, size_t index, const uint8_t *p_src, size_t n, size_t item_size) {
+	(void)p_dst;
+	(void)p_src;
+	(void)item_size;
+	(void)n;
+	*(size_t *)p_context += 1;
+	return index != 0 ? CIRC_BUF_IO_ERROR : CIRC_BUF_NO_ERROR;
+}
+
+void test_transform() {
+	circularBuffer_t buffer;
+	int16_t s16_data[8];
+	int32_t s32_data[4];
+	float output[8];
+	uint16_t planes[8];
+	circularBufferTransformScale_t scale = {0.5f, 1.0f};
+	circularBufferTransformPlanes_t layout = {2, 4};
+	size_t popped;
+	size_t calls = 0;
+	int16_t i;
+	int32_t value;
+
+	circularBuffer_init(&buffer, s16_data, sizeof(s16_data), sizeof(int16_t));
+	assert(circularBufferTransform_popFIFO_n(&buffer, output, 8, &popped, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferTransform_popFIFO_n(&buffer, output, 8, &popped, circularBufferTransform_s16_to_float, &scale) == CIRC_BUF_BUFFER_EMPTY);
+
+	/* -4..3, wrapped */
+	buffer.start = buffer.end = 5;
+	for (i = -4; i < 4; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	assert(circularBufferTransform_popFIFO_n(&buffer, output, 8, &popped, test_transform_fail, &calls) == CIRC_BUF_IO_ERROR);
+	assert(2 == calls && 0 == popped && circularBuffer_is_full(&buffer));
+	assert(circularBufferTransform_popFIFO_n(&buffer, output, 8, &popped, circularBufferTransform_s32_to_float, &scale) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferTransform_popFIFO_n(&buffer, output, 6, &popped, circularBufferTransform_s16_to_float, &scale) == CIRC_BUF_NO_ERROR);
+	assert(6 == popped);
+	assert(-1.0f == output[0] && 1.0f == output[4] && 1.5f == output[5]);
+
+	/* stereo frames L0 R0 L1 R1 ... split into planes */
+	for (i = 100; i < 106; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	circularBuffer_remove_records(&buffer, 2);
+	assert(circularBufferTransform_popFIFO_n(&buffer, planes, 6, &popped, circularBufferTransform_deinterleave, &layout) == CIRC_BUF_NO_ERROR);
+	assert(6 == popped);
+	assert(100 == planes[0] && 102 == planes[1] && 104 == planes[2]);
+	assert(101 == planes[4] && 103 == planes[5] && 105 == planes[6]);
+	layout.plane_items = 1;
+	i = 0;
+	circularBuffer_push(&buffer, &i, NULL);
+	circularBuffer_push(&buffer, &i, NULL);
+	circularBuffer_push(&buffer, &i, NULL);
+	assert(circularBufferTransform_popFIFO_n(&buffer, planes, 3, &popped, circularBufferTransform_deinterleave, &layout) == CIRC_BUF_SIZE_ERROR);
+
+	/* a partial frame is left in the buffer until its other channels arrive */
+	circularBuffer_remove_records(&buffer, buffer.count);
+	layout.plane_items = 4;
+	for (i = 200; i < 205; i++) {
+		circularBuffer_push(&buffer, &i, NULL);
+	}
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 8, &popped, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 1, &popped, &layout) == CIRC_BUF_BUFFER_EMPTY);
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 8, &popped, &layout) == CIRC_BUF_NO_ERROR);
+	assert(4 == popped && 1 == buffer.count);
+	assert(200 == planes[0] && 202 == planes[1] && 201 == planes[4] && 203 == planes[5]);
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 8, &popped, &layout) == CIRC_BUF_BUFFER_EMPTY);
+	assert(0 == popped && 1 == buffer.count);
+	i = 205;
+	circularBuffer_push(&buffer, &i, NULL);
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 8, &popped, &layout) == CIRC_BUF_NO_ERROR);
+	assert(2 == popped && 204 == planes[0] && 205 == planes[4]);
+	layout.channels = 0;
+	assert(circularBufferTransform_popFIFO_planes(&buffer, planes, 8, &popped, &layout) == CIRC_BUF_SIZE_ERROR);
+
+	/* byte swap across the wrap point */
+	circularBuffer_init(&buffer, s32_data, sizeof(s32_data), sizeof(int32_t));
+	buffer.start = buffer.end = 3;
+	value = 0x01020304;
+	circularBuffer_push(&buffer, &value, NULL);
+	value = 0x05060708;
+	circularBuffer_push(&buffer, &value, NULL);
+	assert(circularBufferTransform_popFIFO_n(&buffer, s16_data, 2, &popped, circularBufferTransform_bswap, NULL) == CIRC_BUF_NO_ERROR);
+	memcpy(&value, s16_data, sizeof(value));
+	assert(0x04030201 == value);
+	memcpy(&value, s16_data + 2, sizeof(value));
+	assert(0x08070605 == value);
+}
+
+#define TEST_COMBINE_PRODUCERS 3
+#define TEST_COMBINE_ITEMS 2000
+
+void *test_combine_producer(void *p_arg) {
+	circularBufferCombine_t *p_combine = p_arg;
+	size_t slot;
+	uint32_t value;
+	uint32_t i;
+
+	assert(circularBufferCombine_attach(p_combine, &slot) == CIRC_BUF_NO_ERROR);
+	for (i = 0; i < TEST_COMBINE_ITEMS; i++) {
+		value = ((uint32_t)slot << 16) | i;
+		while (circularBufferCombine_push_n(p_combine, slot, &value, 1) == CIRC_BUF_BUFFER_FULL) {
+			sched_yield();
+		}
+	}
+	assert(circularBufferCombine_detach(p_combine, slot) == CIRC_BUF_NO_ERROR);
+	return NULL;
+}
+
+void test_combine() {
+	circularBufferCombine_t combine;
+	circularBufferCombineSlot_t slots[TEST_COMBINE_PRODUCERS + 1];
+	uint32_t storage[16];
+	uint32_t batch[8];
+	uint32_t next[TEST_COMBINE_PRODUCERS + 1] = {0};
+	pthread_t threads[TEST_COMBINE_PRODUCERS];
+	size_t consumer;
+	size_t other;
+	size_t popped;
+	size_t received = 0;
+	size_t count;
+	size_t i;
+
+	assert(circularBufferCombine_init(&combine, storage, sizeof(storage), sizeof(uint32_t), slots, 0, NULL) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferCombine_init(&combine, storage, sizeof(storage), sizeof(uint32_t), slots, 1, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferCombine_attach(&combine, &consumer) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferCombine_attach(&combine, &other) == CIRC_BUF_BUFFER_FULL);
+	assert(circularBufferCombine_push_n(&combine, 1, batch, 1) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferCombine_popFIFO_n(&combine, consumer, batch, 8, &popped) == CIRC_BUF_BUFFER_EMPTY);
+	assert(0 == popped);
+	assert(circularBufferCombine_push_n(&combine, consumer, storage, 17) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferCombine_detach(&combine, consumer) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferCombine_detach(&combine, consumer) == CIRC_BUF_SIZE_ERROR);
+	assert(circularBufferCombine_destroy(&combine) == CIRC_BUF_NO_ERROR);
+
+	/* producers interleave, but each one's items arrive in order */
+	assert(circularBufferCombine_init(&combine, storage, sizeof(storage), sizeof(uint32_t), slots, TEST_COMBINE_PRODUCERS + 1, NULL) == CIRC_BUF_NO_ERROR);
+	assert(circularBufferCombine_attach(&combine, &consumer) == CIRC_BUF_NO_ERROR);
+	for (i = 0; i < TEST_COMBINE_PRODUCERS; i++) {
+		assert(0 == pthread_create(&threads[i], NULL, test_combine_producer, &combine));
+	}
+	while (received < TEST_COMBINE_PRODUCERS * TEST_COMBINE_ITEMS) {
+		if (circularBufferCombine_popFIFO_n(&combine, consumer, batch, 8, &popped) != CIRC_BUF_NO_ERROR) {
+			sched_yield();
+			continue;
+		}
+		for (i = 0; i < popped; i++) {
+			assert((batch[i] & 0xFFFFu) == next[batch[i] >> 16]);
+			next[batch[i] >> 16]++;
+		}
+		received += popped;
+	}
+	for (i = 0; i < TEST_COMBINE_PRODUCERS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	assert(circularBufferCombine_getCount(&combine, &count) == CIRC_BUF_NO_ERROR);
+	assert(0 == count);
+	assert(circularBufferCombine_destroy(&combine) == CIRC_BUF_NO_ERROR);
+}
+
+void test_push_multi() {
+	circularBuffer_t buffers[3];
+	circularBuffer_t narrow;
+	circularBuffer_t *targets[4];
+	uint32_t storage[3][2];
+	uint16_t narrow_storage[2];
+	int status[4];
+	uint32_t value = 7;
+	uint32_t output;
+	size_t i;
+
+	for (i = 0; i < 3; i++) {
+		circularBuffer_init(&buffers[i], storage[i], sizeof(storage[i]), sizeof(uint32_t));
+		targets[i] = &buffers[i];
+	}
+	assert(circularBuffer_push_multi(NULL, 3, &value, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_push_multi(targets, 3, NULL, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(circularBuffer_push_multi(targets, 0, &value, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_SIZE_ERROR);
+
+	assert(circularBuffer_push_multi(targets, 3, &value, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_NO_ERROR);
+	assert(CIRC_BUF_NO_ERROR == status[0] && CIRC_BUF_NO_ERROR == status[1] && CIRC_BUF_NO_ERROR == status[2]);
+
+	/* fill the middle buffer: all-or-nothing pushes nowhere */
+	circularBuffer_push(&buffers[1], &value, NULL);
+	value = 8;
+	assert(circularBuffer_push_multi(targets, 3, &value, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_BUFFER_FULL);
+	assert(CIRC_BUF_SKIPPED == status[0] && CIRC_BUF_BUFFER_FULL == status[1] && CIRC_BUF_SKIPPED == status[2]);
+	assert(1 == buffers[0].count && 1 == buffers[2].count);
+
+	/* best effort pushes to the others and reports the full one */
+	circularBuffer_init(&narrow, narrow_storage, sizeof(narrow_storage), sizeof(uint16_t));
+	targets[3] = &narrow;
+	assert(circularBuffer_push_multi(targets, 4, &value, CIRC_BUF_MULTI_ANY, status, memcpy) == CIRC_BUF_BUFFER_FULL);
+	assert(CIRC_BUF_NO_ERROR == status[0] && CIRC_BUF_BUFFER_FULL == status[1]);
+	assert(CIRC_BUF_NO_ERROR == status[2] && CIRC_BUF_SIZE_ERROR == status[3]);
+	assert(0 == narrow.count);
+	for (i = 0; i < 3; i += 2) {
+		assert(circularBuffer_popLIFO(&buffers[i], &output, NULL) == CIRC_BUF_NO_ERROR);
+		assert(8 == output);
+		assert(circularBuffer_popLIFO(&buffers[i], &output, NULL) == CIRC_BUF_NO_ERROR);
+		assert(7 == output);
+	}
+
+	/* a repeated buffer is rejected, not pushed to twice */
+	targets[1] = &buffers[0];
+	targets[2] = &buffers[0];
+	assert(circularBuffer_push_multi(targets, 2, &value, CIRC_BUF_MULTI_ALL, status, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(CIRC_BUF_SKIPPED == status[0] && CIRC_BUF_ADDR_ERROR == status[1]);
+	assert(0 == buffers[0].count);
+	assert(circularBuffer_push_multi(targets, 3, &value, CIRC_BUF_MULTI_ANY, NULL, NULL) == CIRC_BUF_ADDR_ERROR);
+	assert(1 == buffers[0].count);
+}
+
 int main() {
 	test_init();
 	test_push_peek_pop();
@@ -496,5 +2344,34 @@ int main() {
 	test_pop_lifo();
 	test_copy_buffer();
 	test_flush();
+	test_agg_window();
+	test_agg_double();
+	test_agg_exact();
+	test_peek_spans();
+	test_drain();
+	test_drain_writer();
+	test_serialize();
+	test_shm();
+	test_seqlock_snapshot();
+	test_latency();
+	test_wsdeque();
+	test_multicast();
+	test_watermark();
+	test_coalesce();
+	test_push_iov();
+	test_compact();
+	test_stream_memcpy();
+	test_parallel_copy();
+	test_item_sizes();
+	test_storage_alloc();
+	test_storage_trim();
+	test_storage_trim_huge();
+	test_read_txn();
+	test_find_byte();
+	test_filter();
+	test_sync();
+	test_transform();
+	test_combine();
+	test_push_multi();
 	return 0;
 }
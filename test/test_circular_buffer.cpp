@@ -0,0 +1,127 @@
+#include "fk_circular_buffer.hpp"
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <numeric>
+#include <string>
+
+void test_ring_static() {
+	fk::ring<int, 4> ring;
+
+	static_assert(fk::ring<int, 4>::capacity() == 4);
+	assert(ring.empty() && !ring.try_pop());
+	for (int i = 0; i < 4; i++) {
+		assert(ring.try_push(i));
+	}
+	assert(ring.full() && !ring.try_push(4));
+	assert(ring.try_pop() == 0);
+	ring.push_back(4);
+	assert(ring.front() == 1 && ring.back() == 4 && ring[2] == 3);
+	assert(ring.try_pop_back() == 4);
+	ring.emplace_back(5);
+
+	/* contents are 1 2 3 5, wrapped in storage */
+	assert(std::accumulate(ring.begin(), ring.end(), 0) == 11);
+	assert(ring.end() - ring.begin() == 4);
+	assert(*(ring.begin() + 3) == 5 && ring.begin()[1] == 2);
+	assert(*ring.rbegin() == 5);
+	assert(std::is_sorted(ring.cbegin(), ring.cend()));
+	*std::find(ring.begin(), ring.end(), 3) = 7;
+	std::sort(ring.begin(), ring.end(), std::greater<int>());
+	assert(ring[0] == 7 && ring[3] == 1);
+	fk::ring<int, 4>::const_iterator it = ring.begin();
+	assert(it == ring.cbegin() && it < ring.cend());
+
+	assert(ring.remove(2) == 2 && ring.size() == 2);
+	assert(ring.remove(5) == 2 && ring.empty());
+}
+
+void test_ring_move_only() {
+	alignas(std::unique_ptr<std::string>) unsigned char storage[3 * sizeof(std::unique_ptr<std::string>) + 1];
+	fk::ring<std::unique_ptr<std::string>> ring(storage, sizeof(storage));
+	std::unique_ptr<std::string> item = std::make_unique<std::string>("d");
+
+	assert(ring.capacity() == 3);
+	ring.emplace_back(std::make_unique<std::string>("a"));
+	ring.push_back(std::make_unique<std::string>("b"));
+	assert(ring.try_push(std::make_unique<std::string>("c")));
+	assert(!ring.try_push(std::move(item)) && item);
+	assert(*ring.try_pop().value() == "a");
+	assert(ring.try_push(std::move(item)) && !item);
+	assert(*ring.front() == "b" && *ring.back() == "d");
+	ring.pop_front();
+	/* the remaining elements are released by the destructor */
+}
+
+#ifdef __cpp_lib_span
+void test_ring_span() {
+	fk::ring<std::string, 5> ring;
+	std::string in[4] = {"a", "b", "c", "d"};
+	std::string out[4];
+
+	assert(ring.push(std::span<const std::string>(in, 3)));
+	assert(ring.pop(std::span<std::string>(out, 2)) == 2);
+	assert(out[0] == "a" && out[1] == "b");
+	/* wraps around the end of storage */
+	assert(ring.push(std::span<const std::string>(in, 4)));
+	assert(!ring.push(std::span<const std::string>(in, 1)));
+	assert(ring.pop(std::span<std::string>(out)) == 4);
+	assert(out[0] == "c" && out[1] == "a" && out[3] == "c");
+	assert(ring.size() == 1 && ring.front() == "d");
+}
+
+struct copy_bomb {
+	static int live;
+	static int copies_left;
+	int value;
+
+	explicit copy_bomb(int v) : value(v) { live++; }
+	copy_bomb(const copy_bomb &other) : value(other.value)
+	{
+		if (0 == copies_left--) {
+			throw 0;
+		}
+		live++;
+	}
+	~copy_bomb() { live--; }
+};
+int copy_bomb::live = 0;
+int copy_bomb::copies_left = 0;
+
+void test_ring_span_throw() {
+	{
+		fk::ring<copy_bomb, 4> ring;
+		copy_bomb in[3] = {copy_bomb(1), copy_bomb(2), copy_bomb(3)};
+		bool thrown = false;
+
+		copy_bomb::copies_left = 2;
+		ring.emplace_back(0);
+		ring.emplace_back(0);
+		ring.pop_front();
+		ring.pop_front();
+		/* two elements fit before the wrap point; the third copy throws */
+		try {
+			ring.push(std::span<const copy_bomb>(in, 3));
+		} catch (int) {
+			thrown = true;
+		}
+		assert(thrown && ring.empty());
+		assert(copy_bomb::live == 3);
+
+		copy_bomb::copies_left = 3;
+		assert(ring.push(std::span<const copy_bomb>(in, 3)));
+		assert(ring.size() == 3 && ring[2].value == 3);
+	}
+	assert(copy_bomb::live == 0);
+}
+#endif
+
+int main() {
+	test_ring_static();
+	test_ring_move_only();
+#ifdef __cpp_lib_span
+	test_ring_span();
+	test_ring_span_throw();
+#endif
+	return 0;
+}